@@ -0,0 +1,69 @@
+#include <hashlib/af_alg.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+// compares the in-process algorithms with the kernel crypto API, for in-memory messages of several sizes and for a
+// file in the page cache, which the kernel context splices instead of copying it to user space.
+
+namespace {
+    template<typename F>
+    auto measure(F&& f) -> double {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<typename Algo>
+    auto run(const char* name, const std::string& content, const char* filename) -> void {
+        if (!hashlib::af_alg_context<Algo>{}.uses_kernel()) {
+            std::printf("%-9s AF_ALG unavailable, the in-process fallback is measured twice\n", name);
+        }
+        for (std::size_t message_size : {std::size_t(64), std::size_t(1) << 10, std::size_t(64) << 10, std::size_t(1) << 20}) {
+            std::size_t total = std::size_t(32) << 20;
+            auto count = total / message_size;
+            hashlib::span<const hashlib::byte> message{reinterpret_cast<const hashlib::byte*>(content.data()), message_size};
+            auto in_process = measure([&] {
+                for (std::size_t i = 0; i < count; ++i) (void)Algo{message}.digest();
+            });
+            auto kernel = measure([&] {
+                for (std::size_t i = 0; i < count; ++i) (void)hashlib::af_alg_context<Algo>{message}.digest();
+            });
+            std::printf(
+                "%-9s %8zu B messages: in-process %8.1f MiB/s, af_alg %8.1f MiB/s\n",
+                name, message_size, total / in_process / (1 << 20), total / kernel / (1 << 20)
+            );
+        }
+
+        auto in_process = measure([&] { (void)hashlib::hash_file<Algo>(filename).digest(); });
+        auto kernel = measure([&] {
+            int fd = ::open(filename, O_RDONLY);
+            hashlib::af_alg_context<Algo> ctx;
+            ctx.update_from_fd(fd, 0, content.size());
+            (void)ctx.digest();
+            ::close(fd);
+        });
+        std::printf(
+            "%-9s file:              hash_file  %8.1f MiB/s, af_alg %8.1f MiB/s\n",
+            name, content.size() / in_process / (1 << 20), content.size() / kernel / (1 << 20)
+        );
+    }
+}
+
+auto main() -> int {
+    std::string content(std::size_t(256) << 20, '\0');
+    for (std::size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>(i * 131 + i / 7);
+    }
+    const char* filename = "hashlib-bench-af_alg.bin";
+    {
+        std::ofstream file{filename, std::ios::out | std::ios::binary};
+        file << content;
+    }
+    run<hashlib::md5>("md5", content, filename);
+    run<hashlib::sha1>("sha1", content, filename);
+    run<hashlib::sha256>("sha256", content, filename);
+    run<hashlib::sha512>("sha512", content, filename);
+    run<hashlib::sha3_256>("sha3-256", content, filename);
+    std::remove(filename);
+}
@@ -46,9 +46,15 @@ class HashlibRecipe(ConanFile):
 
     def package_info(self):
         self.cpp_info.set_property("cmake_file_name", "hashlib")
-        self.cpp_info.set_property("cmake_target_name", "hashlib::hashlib")
-        self.cpp_info.libs = []
-        self.cpp_info.includedirs = ["hashlib/include"]
+        self.cpp_info.components["core"].set_property("cmake_target_name", "hashlib::hashlib")
+        self.cpp_info.components["core"].libs = []
+        self.cpp_info.components["core"].includedirs = ["hashlib/include"]
+        self.cpp_info.components["threads"].set_property("cmake_target_name", "hashlib::threads")
+        self.cpp_info.components["threads"].requires = ["core"]
+        self.cpp_info.components["threads"].libs = []
+        self.cpp_info.components["threads"].includedirs = []
+        if self.settings.os in ["Linux", "FreeBSD"]:
+            self.cpp_info.components["threads"].system_libs = ["pthread"]
 
     def package_id(self):
         self.info.clear()
\ No newline at end of file
@@ -0,0 +1,250 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "md5.hpp"
+#include "sha1.hpp"
+#include "sha2.hpp"
+#include "sha3.hpp"
+#include "file.hpp"
+#include <cstring>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/if_alg.h>)
+#include <linux/if_alg.h>
+#include <sys/socket.h>
+#endif
+#endif
+#endif
+
+#if defined(__linux__) && defined(ALG_SET_KEY) && defined(SPLICE_F_MORE)
+#define HASHLIB_HAS_AF_ALG 1
+#else
+#define HASHLIB_HAS_AF_ALG 0
+#endif
+
+namespace hashlib {
+    namespace detail {
+        template<typename Algo>
+        struct af_alg_name;
+
+#define HASHLIB_AF_ALG_NAME(algo, name) \
+        template<> \
+        struct af_alg_name<algo> { \
+            static auto get() noexcept -> const char* { \
+                return name; \
+            } \
+        }
+
+        HASHLIB_AF_ALG_NAME(hashlib::md5, "md5");
+        HASHLIB_AF_ALG_NAME(hashlib::sha1, "sha1");
+        HASHLIB_AF_ALG_NAME(hashlib::sha224, "sha224");
+        HASHLIB_AF_ALG_NAME(hashlib::sha256, "sha256");
+        HASHLIB_AF_ALG_NAME(hashlib::sha384, "sha384");
+        HASHLIB_AF_ALG_NAME(hashlib::sha512, "sha512");
+        HASHLIB_AF_ALG_NAME(hashlib::sha3_224, "sha3-224");
+        HASHLIB_AF_ALG_NAME(hashlib::sha3_256, "sha3-256");
+        HASHLIB_AF_ALG_NAME(hashlib::sha3_384, "sha3-384");
+        HASHLIB_AF_ALG_NAME(hashlib::sha3_512, "sha3-512");
+#undef HASHLIB_AF_ALG_NAME
+
+        [[noreturn]] inline auto throw_last_error(const char* what) -> void {
+            throw std::system_error{last_error_code(), what};
+        }
+    }
+
+    // a context which hashes through the linux kernel crypto API (`AF_ALG` sockets), so that hardware drivers are
+    // used and file data can be spliced to the kernel without being copied into user space.
+    // when the kernel interface is unavailable, the in-process `Algo` is used instead, `uses_kernel` tells which.
+    // unlike `context<Base>`, the operations may throw `std::system_error` when the kernel reports an error.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    class af_alg_context {
+    public:
+        static constexpr std::size_t digest_size = Algo::digest_size;
+
+    public:
+        af_alg_context() : op_fd_(open_op_()) {}
+
+        explicit af_alg_context(span<const byte> bytes) : af_alg_context() {
+            this->update(bytes);
+        }
+
+        // the kernel state is cloned by `accept` on the operation socket
+        af_alg_context(const af_alg_context& other) : fallback_(other.fallback_), op_fd_(other.clone_op_()) {}
+
+        af_alg_context(af_alg_context&& other) noexcept : fallback_(other.fallback_), op_fd_(other.op_fd_) {
+            other.op_fd_ = -1;
+        }
+
+        ~af_alg_context() {
+            close_op_(op_fd_);
+        }
+
+        auto operator= (af_alg_context other) noexcept -> af_alg_context& {
+            std::swap(fallback_, other.fallback_);
+            std::swap(op_fd_, other.op_fd_);
+            return *this;
+        }
+
+        HASHLIB_NODISCARD auto uses_kernel() const noexcept -> bool {
+            return op_fd_ >= 0;
+        }
+
+        auto update(span<const byte> bytes) -> void {
+#if HASHLIB_HAS_AF_ALG
+            if (uses_kernel()) {
+                auto data = bytes.data();
+                auto remaining = bytes.size();
+                while (remaining > 0) {
+                    auto n = ::send(op_fd_, data, remaining, MSG_MORE);
+                    if (n < 0) {
+                        if (errno == EINTR) continue;
+                        detail::throw_last_error("hashlib::af_alg_context::update");
+                    }
+                    data += n;
+                    remaining -= static_cast<std::size_t>(n);
+                }
+                return;
+            }
+#endif
+            fallback_.update(bytes);
+        }
+
+        template<typename Range, detail::enable_if_t<
+            detail::is_input_range<Range>::value &&
+            detail::is_contiguous_iterator<detail::range_iter_t<Range>>::value &&
+            detail::is_byte_like<detail::range_value_t<Range>>::value
+        >* = nullptr>
+        auto update(Range&& rng) -> void {
+            auto first = std::begin(rng);
+            this->update(detail::contiguous_bytes(first, static_cast<std::size_t>(std::end(rng) - first)));
+        }
+
+#if HASHLIB_PLATFORM_POSIX
+        // hashes `count` bytes of `fd` starting at `offset`, in the kernel the bytes are spliced through a pipe to the
+        // operation socket and never copied to user space. `fd` shall support `splice`, e.g. a regular file.
+        auto update_from_fd(int fd, std::uint64_t offset, std::uint64_t count) -> void {
+#if HASHLIB_HAS_AF_ALG
+            if (uses_kernel()) {
+                splice_(fd, offset, count);
+                return;
+            }
+#endif
+            std::unique_ptr<byte[]> buffer{new byte[detail::file_read_size]};
+            while (count > 0) {
+                auto n = ::pread(
+                    fd,
+                    buffer.get(),
+                    static_cast<std::size_t>((std::min<std::uint64_t>)(count, detail::file_read_size)),
+                    static_cast<off_t>(offset)
+                );
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) detail::throw_last_error("hashlib::af_alg_context::update_from_fd");
+                if (n == 0) break;
+                fallback_.update({buffer.get(), static_cast<std::size_t>(n)});
+                offset += static_cast<std::uint64_t>(n);
+                count -= static_cast<std::uint64_t>(n);
+            }
+        }
+#endif
+
+        HASHLIB_NODISCARD auto digest() -> std::array<byte, digest_size> {
+#if HASHLIB_HAS_AF_ALG
+            if (uses_kernel()) {
+                // reading finalizes the hash, so it is read from a clone to keep this context usable
+                int clone = clone_op_();
+                std::array<byte, digest_size> result; // NOLINT(*-pro-type-member-init)
+                std::size_t received = 0;
+                while (received < digest_size) {
+                    auto n = ::recv(clone, result.data() + received, digest_size - received, 0);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) {
+                        close_op_(clone);
+                        detail::throw_last_error("hashlib::af_alg_context::digest");
+                    }
+                    received += static_cast<std::size_t>(n);
+                }
+                close_op_(clone);
+                return result;
+            }
+#endif
+            return fallback_.digest();
+        }
+
+        HASHLIB_NODISCARD auto hexdigest() -> std::string {
+            auto result = digest();
+            return detail::to_hex({result.data(), result.size()});
+        }
+
+        auto clear() -> void {
+            *this = af_alg_context{};
+        }
+
+    private:
+        static auto open_op_() noexcept -> int {
+#if HASHLIB_HAS_AF_ALG
+            // the transform socket is bound once per algorithm, every context accepts its own operation socket from it
+            static const int tfm_fd = [] {
+                int fd = ::socket(AF_ALG, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+                if (fd < 0) return -1;
+                sockaddr_alg addr{};
+                addr.salg_family = AF_ALG;
+                std::strcpy(reinterpret_cast<char*>(addr.salg_type), "hash");
+                std::strcpy(reinterpret_cast<char*>(addr.salg_name), detail::af_alg_name<Algo>::get());
+                if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+                    ::close(fd);
+                    return -1;
+                }
+                return fd;
+            }();
+            if (tfm_fd < 0) return -1;
+            return ::accept4(tfm_fd, nullptr, nullptr, SOCK_CLOEXEC);
+#else
+            return -1;
+#endif
+        }
+
+        static auto close_op_(int fd) noexcept -> void {
+            if (fd >= 0) ::close(fd);
+        }
+
+        auto clone_op_() const -> int {
+            if (op_fd_ < 0) return -1;
+#if HASHLIB_HAS_AF_ALG
+            int fd = ::accept4(op_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) detail::throw_last_error("hashlib::af_alg_context");
+            return fd;
+#else
+            return -1;
+#endif
+        }
+
+#if HASHLIB_HAS_AF_ALG
+        auto splice_(int fd, std::uint64_t offset, std::uint64_t count) -> void {
+            int pipe_fds[2];
+            if (::pipe2(pipe_fds, O_CLOEXEC) != 0) detail::throw_last_error("hashlib::af_alg_context::update_from_fd");
+            detail::file_descriptor read_end{pipe_fds[0]}, write_end{pipe_fds[1]};
+            std::size_t pipe_size = std::size_t(1) << 20;
+            if (::fcntl(write_end.get(), F_SETPIPE_SZ, static_cast<int>(pipe_size)) < 0) pipe_size = std::size_t(64) << 10;
+
+            auto off = static_cast<loff_t>(offset);
+            while (count > 0) {
+                auto chunk = static_cast<std::size_t>((std::min<std::uint64_t>)(count, pipe_size));
+                auto n = ::splice(fd, &off, write_end.get(), nullptr, chunk, SPLICE_F_MOVE | SPLICE_F_MORE);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) detail::throw_last_error("hashlib::af_alg_context::update_from_fd");
+                if (n == 0) break;
+                count -= static_cast<std::uint64_t>(n);
+                // `SPLICE_F_MORE` becomes `MSG_MORE`, which keeps the kernel from finalizing the hash
+                while (n > 0) {
+                    auto m = ::splice(read_end.get(), nullptr, op_fd_, nullptr, static_cast<std::size_t>(n), SPLICE_F_MOVE | SPLICE_F_MORE);
+                    if (m < 0 && errno == EINTR) continue;
+                    if (m <= 0) detail::throw_last_error("hashlib::af_alg_context::update_from_fd");
+                    n -= m;
+                }
+            }
+        }
+#endif
+
+    private:
+        Algo fallback_;
+        int op_fd_ = -1;
+    };
+}
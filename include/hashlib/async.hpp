@@ -0,0 +1,155 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "file.hpp"
+#include "executor.hpp"
+#include <exception>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <stop_token>
+#endif
+#endif
+
+#if HASHLIB_CXX_STANDARD >= HASHLIB_CXX_STD20 && defined(__cpp_impl_coroutine) && defined(__cpp_lib_jthread)
+#define HASHLIB_HAS_COROUTINES 1
+#else
+#define HASHLIB_HAS_COROUTINES 0
+#endif
+
+#if HASHLIB_HAS_COROUTINES
+namespace hashlib {
+    namespace detail {
+        // reads a file chunk by chunk, every chunk being an independent call.
+        class chunked_file_reader {
+        public:
+            auto open(const std::string& path, std::error_code& ec) -> void {
+#if HASHLIB_PLATFORM_POSIX
+                fd_ = open_read_only(path);
+                if (fd_ < 0) {
+                    ec = last_error_code();
+                    return;
+                }
+                advise_sequential(fd_);
+#else
+                open_read_only(path, file_, ec);
+#endif
+            }
+
+            chunked_file_reader() = default;
+
+            chunked_file_reader(const chunked_file_reader&) = delete;
+
+            ~chunked_file_reader() {
+#if HASHLIB_PLATFORM_POSIX
+                if (fd_ >= 0) ::close(fd_);
+#endif
+            }
+
+            auto operator= (const chunked_file_reader&) -> chunked_file_reader& = delete;
+
+            // returns 0 at the end of the file or on error.
+            auto read(byte* data, std::size_t size, std::error_code& ec) -> std::size_t {
+#if HASHLIB_PLATFORM_POSIX
+                return read_some(fd_, data, size, ec);
+#else
+                return read_some(file_, data, size, ec);
+#endif
+            }
+
+        private:
+#if HASHLIB_PLATFORM_POSIX
+            int fd_ = -1;
+#else
+            std::ifstream file_;
+#endif
+        };
+    }
+
+    // the awaitable returned by `async_hash_file`.
+    // every chunk is read and hashed by a separate task submitted to the executor, so a large file never occupies a
+    // thread for long and other work may run between two chunks. the awaiting coroutine is resumed on the executor.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Executor>
+    class async_hash_file_awaitable {
+    public:
+        async_hash_file_awaitable(std::string path, Executor executor, std::stop_token token)
+            : path_(std::move(path)), executor_(std::move(executor)), token_(std::move(token)) {}
+
+        async_hash_file_awaitable(const async_hash_file_awaitable&) = delete;
+
+        auto operator= (const async_hash_file_awaitable&) -> async_hash_file_awaitable& = delete;
+
+        HASHLIB_NODISCARD auto await_ready() const noexcept -> bool {
+            return false;
+        }
+
+        auto await_suspend(std::coroutine_handle<> continuation) -> void {
+            continuation_ = continuation;
+            schedule_();
+        }
+
+        // throws `std::system_error` on I/O errors, or with `std::errc::operation_canceled` if a stop was requested.
+        auto await_resume() -> Algo {
+            if (exception_) std::rethrow_exception(exception_);
+            if (ec_) throw std::system_error{ec_, "hashlib::async_hash_file: " + path_};
+            return std::move(ctx_);
+        }
+
+    private:
+        auto schedule_() -> void {
+            // the task may complete and destroy this awaitable before `execute` returns
+            auto executor = executor_;
+            executor.execute([this] { step_(); });
+        }
+
+        auto step_() noexcept -> void {
+            try {
+                if (advance_()) return;
+            } catch (...) {
+                exception_ = std::current_exception();
+            }
+            continuation_.resume();
+        }
+
+        // hashes one chunk, returns whether the next one has been scheduled.
+        auto advance_() -> bool {
+            if (!buffer_) {
+                buffer_.reset(new byte[detail::file_read_size]);
+                reader_.open(path_, ec_);
+                if (ec_) return false;
+            }
+            if (token_.stop_requested()) {
+                ec_ = std::make_error_code(std::errc::operation_canceled);
+                return false;
+            }
+            auto n = reader_.read(buffer_.get(), detail::file_read_size, ec_);
+            if (n == 0) return false;
+            ctx_.update({buffer_.get(), n});
+            schedule_();
+            return true;
+        }
+
+    private:
+        std::string path_;
+        Executor executor_;
+        std::stop_token token_;
+        std::coroutine_handle<> continuation_;
+        detail::chunked_file_reader reader_;
+        std::unique_ptr<byte[]> buffer_;
+        Algo ctx_;
+        std::error_code ec_;
+        std::exception_ptr exception_;
+    };
+
+    // hashes the file at `path` without blocking the awaiting coroutine, e.g.
+    // `auto ctx = co_await hashlib::async_hash_file<hashlib::sha256>(path, executor, token);`
+    // `executor` is copied, see `is_executor`.
+    // the hashing stops between two chunks when a stop is requested through `token`.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Executor>
+    HASHLIB_NODISCARD auto async_hash_file(
+        std::string path,
+        Executor executor,
+        std::stop_token token = {}
+    ) -> async_hash_file_awaitable<Algo, Executor> {
+        return {std::move(path), std::move(executor), std::move(token)};
+    }
+}
+#endif
@@ -0,0 +1,465 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "file.hpp"
+#include <vector>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+#endif
+
+#if defined(__linux__) && defined(IORING_OFF_SQ_RING) && defined(__NR_io_uring_setup)
+#define HASHLIB_HAS_IO_URING 1
+#else
+#define HASHLIB_HAS_IO_URING 0
+#endif
+
+namespace hashlib {
+    // options of the batch file hasher, see `hash_files_batch`.
+    HASHLIB_MOD_EXPORT struct batch_options {
+        // number of reads kept in flight across all files.
+        std::size_t queue_depth = 64;
+        // size of each read.
+        std::size_t chunk_size = std::size_t(256) << 10;
+        // number of files which are open and being hashed at the same time.
+        std::size_t max_open_files = 64;
+    };
+
+    namespace detail {
+#if HASHLIB_HAS_IO_URING
+        class io_uring_ring {
+        public:
+            explicit io_uring_ring(unsigned entries) noexcept {
+                io_uring_params params{};
+                fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (fd_ < 0) return;
+                entries_ = params.sq_entries;
+
+                sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_mmap) sq_size_ = cq_size_ = (std::max)(sq_size_, cq_size_);
+
+                sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+                if (sq_ptr_ == MAP_FAILED) {
+                    close_();
+                    return;
+                }
+                cq_ptr_ = single_mmap ? sq_ptr_ :
+                    ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+                if (cq_ptr_ == MAP_FAILED) {
+                    close_();
+                    return;
+                }
+                sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+                void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+                if (sqes == MAP_FAILED) {
+                    close_();
+                    return;
+                }
+                sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+                auto sq = static_cast<char*>(sq_ptr_);
+                sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+                sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                auto cq = static_cast<char*>(cq_ptr_);
+                cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            }
+
+            io_uring_ring(const io_uring_ring&) = delete;
+
+            ~io_uring_ring() {
+                close_();
+            }
+
+            auto operator= (const io_uring_ring&) -> io_uring_ring& = delete;
+
+            HASHLIB_NODISCARD auto valid() const noexcept -> bool {
+                return sqes_ != nullptr;
+            }
+
+            HASHLIB_NODISCARD auto entries() const noexcept -> unsigned {
+                return entries_;
+            }
+
+            auto register_resource(unsigned opcode, const void* arg, unsigned count) noexcept -> bool {
+                return ::syscall(__NR_io_uring_register, fd_, opcode, arg, count) == 0;
+            }
+
+            // returns `nullptr` when the submission queue is full, `submit_and_wait` makes room.
+            auto get_sqe() noexcept -> io_uring_sqe* {
+                unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+                unsigned tail = *sq_tail_ + pending_;
+                if (tail - head >= entries_) return nullptr;
+                unsigned index = tail & sq_mask_;
+                sq_array_[index] = index;
+                ++pending_;
+                auto sqe = &sqes_[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                return sqe;
+            }
+
+            // submits every queued request, including the ones a previous call could not submit, and waits for
+            // `wait_count` completions. returns 0 or the errno of the failure, `EAGAIN` and `EBUSY` are backpressure:
+            // the requests not submitted yet stay queued and the call can be repeated once completions are reaped.
+            auto submit_and_wait(unsigned wait_count) noexcept -> int {
+                __atomic_store_n(sq_tail_, *sq_tail_ + pending_, __ATOMIC_RELEASE);
+                unsubmitted_ += pending_;
+                pending_ = 0;
+                for (;;) {
+                    auto ret = ::syscall(__NR_io_uring_enter, fd_, unsubmitted_, wait_count, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (ret < 0) {
+                        if (errno == EINTR) continue;
+                        return errno;
+                    }
+                    // the kernel consumed `ret` entries, it only waits once all of them are submitted
+                    auto submitted = static_cast<unsigned>(ret);
+                    unsubmitted_ -= submitted;
+                    in_flight_ += submitted;
+                    if (unsubmitted_ == 0) return 0;
+                    if (submitted == 0) return EAGAIN;
+                }
+            }
+
+            // the number of submitted requests whose completion has not been reaped yet.
+            HASHLIB_NODISCARD auto in_flight() const noexcept -> unsigned {
+                return in_flight_;
+            }
+
+            template<typename Fn>
+            auto for_each_cqe(Fn&& fn) -> unsigned {
+                unsigned head = *cq_head_;
+                unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+                unsigned count = 0;
+                for (; head != tail; ++head, ++count) {
+                    const auto& cqe = cqes_[head & cq_mask_];
+                    fn(cqe.user_data, cqe.res);
+                }
+                __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+                in_flight_ -= count;
+                return count;
+            }
+
+            // waits for every submitted request, so that no read writes to the buffers afterwards. the completions
+            // are discarded, returns false if the ring fails while waiting.
+            auto wait_in_flight() noexcept -> bool {
+                while (in_flight_ > 0) {
+                    for_each_cqe([](std::uint64_t, int) {});
+                    if (in_flight_ == 0) break;
+                    auto ret = ::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+                }
+                return true;
+            }
+
+        private:
+            auto close_() noexcept -> void {
+                if (sqes_) ::munmap(sqes_, sqes_size_);
+                if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_size_);
+                if (sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_size_);
+                if (fd_ >= 0) ::close(fd_);
+                sqes_ = nullptr;
+                cq_ptr_ = sq_ptr_ = MAP_FAILED;
+                fd_ = -1;
+            }
+
+        private:
+            int fd_ = -1;
+            unsigned entries_ = 0;
+            unsigned pending_ = 0;
+            unsigned unsubmitted_ = 0;
+            unsigned in_flight_ = 0;
+            void* sq_ptr_ = MAP_FAILED;
+            void* cq_ptr_ = MAP_FAILED;
+            std::size_t sq_size_ = 0;
+            std::size_t cq_size_ = 0;
+            std::size_t sqes_size_ = 0;
+            io_uring_sqe* sqes_ = nullptr;
+            unsigned* sq_head_ = nullptr;
+            unsigned* sq_tail_ = nullptr;
+            unsigned sq_mask_ = 0;
+            unsigned* sq_array_ = nullptr;
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned cq_mask_ = 0;
+            io_uring_cqe* cqes_ = nullptr;
+        };
+
+        // keeps up to `queue_depth` reads in flight across up to `max_open_files` files, the chunks of every file are
+        // hashed in file order as soon as the chunk before them has been hashed.
+        template<typename Algo, typename Callback>
+        auto hash_files_uring(const std::vector<std::string>& paths, Callback& on_complete, const batch_options& options) -> bool {
+            auto queue_depth = static_cast<unsigned>((std::min)((std::max)(options.queue_depth, std::size_t(1)), std::size_t(4096)));
+            auto max_open_files = static_cast<unsigned>((std::max)(options.max_open_files, std::size_t(1)));
+            std::size_t chunk_size = (std::max)(options.chunk_size, std::size_t(1));
+            // declared before the ring, so that the ring is torn down first
+            aligned_buffer arena{chunk_size * queue_depth, false};
+            io_uring_ring ring{queue_depth};
+            if (!ring.valid()) return false;
+            queue_depth = (std::min)(queue_depth, ring.entries());
+
+            struct slot {
+                std::size_t file;
+                std::uint64_t offset;
+                std::size_t length;
+                std::size_t result;
+                iovec iov;
+            };
+            struct open_file {
+                std::size_t index;
+                file_descriptor fd;
+                std::uint64_t size;
+                std::uint64_t submit_offset = 0;
+                std::uint64_t hash_offset = 0;
+                std::size_t in_flight = 0;
+                bool eof = false;
+                std::error_code ec;
+                Algo ctx;
+                std::vector<std::size_t> completed;
+
+                open_file(std::size_t index, int fd, std::uint64_t size) : index(index), fd(fd), size(size) {}
+            };
+
+            std::vector<slot> slots(queue_depth);
+            std::vector<std::size_t> free_slots;
+            for (unsigned i = 0; i < queue_depth; ++i) {
+                slots[i].iov.iov_base = arena.data() + i * chunk_size;
+                slots[i].iov.iov_len = chunk_size;
+                free_slots.push_back(queue_depth - 1 - i);
+            }
+            std::vector<iovec> iovecs;
+            for (auto& s : slots) iovecs.push_back(s.iov);
+            bool fixed_buffers = ring.register_resource(IORING_REGISTER_BUFFERS, iovecs.data(), queue_depth);
+            std::vector<int> fixed_fds(max_open_files, -1);
+            bool fixed_files = ring.register_resource(IORING_REGISTER_FILES, fixed_fds.data(), max_open_files);
+
+            // `files[i]` is registered at index `i` of the fixed file table when `fixed_files` is set
+            std::vector<std::unique_ptr<open_file>> files(max_open_files);
+            std::size_t open_count = 0;
+            std::size_t next_path = 0;
+
+            auto set_fixed_file = [&](std::size_t index, int fd) {
+                if (!fixed_files) return;
+                io_uring_files_update update{};
+                update.offset = static_cast<std::uint32_t>(index);
+                update.fds = reinterpret_cast<std::uint64_t>(&fd);
+                ring.register_resource(IORING_REGISTER_FILES_UPDATE, &update, 1);
+            };
+
+            auto finish = [&](std::size_t index) {
+                auto& file = *files[index];
+                for (auto s : file.completed) free_slots.push_back(s);
+                set_fixed_file(index, -1);
+                on_complete(file.index, file.ctx, file.ec);
+                files[index].reset();
+                --open_count;
+            };
+
+            auto open_next = [&](std::size_t index) -> bool {
+                while (next_path < paths.size()) {
+                    std::size_t path_index = next_path++;
+                    std::error_code ec;
+                    int fd = open_read_only(paths[path_index]);
+                    struct stat st{};
+                    if (fd < 0 || ::fstat(fd, &st) != 0) {
+                        ec = last_error_code();
+                        if (fd >= 0) ::close(fd);
+                        Algo ctx;
+                        on_complete(path_index, ctx, ec);
+                        continue;
+                    }
+                    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+                        // pipes and devices have no meaningful offsets, and procfs or sysfs files report a size of 0
+                        // whatever their content. they are read synchronously
+                        file_descriptor guard{fd};
+                        Algo ctx;
+                        hash_fd_by_read(ctx, fd, ec);
+                        on_complete(path_index, ctx, ec);
+                        continue;
+                    }
+                    files[index].reset(new open_file{path_index, fd, static_cast<std::uint64_t>(st.st_size)});
+                    ++open_count;
+                    set_fixed_file(index, fd);
+                    return true;
+                }
+                return false;
+            };
+
+            auto drain = [&](std::size_t index) {
+                auto& file = *files[index];
+                for (;;) {
+                    auto it = std::find_if(file.completed.begin(), file.completed.end(), [&](std::size_t s) {
+                        return slots[s].offset == file.hash_offset;
+                    });
+                    if (it == file.completed.end()) break;
+                    auto s = *it;
+                    file.completed.erase(it);
+                    auto& sl = slots[s];
+                    auto data = static_cast<byte*>(sl.iov.iov_base);
+                    // short reads are rare on regular files, the rest of the chunk is read synchronously
+                    while (sl.result < sl.length && !file.eof && !file.ec) {
+                        auto n = ::pread(file.fd.get(), data + sl.result, sl.length - sl.result, static_cast<off_t>(sl.offset + sl.result));
+                        if (n < 0 && errno == EINTR) continue;
+                        if (n < 0) file.ec = last_error_code();
+                        else if (n == 0) file.eof = true;
+                        else sl.result += static_cast<std::size_t>(n);
+                    }
+                    if (!file.ec) {
+                        file.ctx.update({data, sl.result});
+                        file.hash_offset += sl.result;
+                    }
+                    free_slots.push_back(s);
+                }
+                if (file.in_flight == 0 && (file.ec || file.eof || file.hash_offset >= file.size)) {
+                    finish(index);
+                }
+            };
+
+            // hashes the chunks which have completed, returns how many there were.
+            auto reap = [&]() -> unsigned {
+                std::vector<std::size_t> touched;
+                auto count = ring.for_each_cqe([&](std::uint64_t user_data, int res) {
+                    auto s = static_cast<std::size_t>(user_data);
+                    auto& sl = slots[s];
+                    auto& file = *files[sl.file];
+                    --file.in_flight;
+                    if (res < 0) {
+                        if (!file.ec) file.ec = std::error_code{-res, std::generic_category()};
+                        free_slots.push_back(s);
+                    }
+                    else {
+                        sl.result = static_cast<std::size_t>(res);
+                        file.completed.push_back(s);
+                    }
+                    touched.push_back(sl.file);
+                });
+                std::sort(touched.begin(), touched.end());
+                touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+                for (auto index : touched) drain(index);
+                return count;
+            };
+
+            std::size_t cursor = 0;
+            for (;;) {
+                for (std::size_t i = 0; i < max_open_files; ++i) {
+                    if (!files[i]) open_next(i);
+                }
+                if (open_count == 0) break;
+
+                // one chunk per file in turn, so that every open file makes progress
+                bool queued = true;
+                bool ring_full = false;
+                unsigned submitted = 0;
+                while (queued && !ring_full && !free_slots.empty()) {
+                    queued = false;
+                    for (std::size_t n = 0; n < max_open_files && !free_slots.empty(); ++n) {
+                        std::size_t index = cursor++ % max_open_files;
+                        auto file = files[index].get();
+                        if (!file || file->ec || file->eof || file->submit_offset >= file->size) continue;
+                        auto sqe = ring.get_sqe();
+                        if (!sqe) {
+                            ring_full = true;
+                            break;
+                        }
+                        auto s = free_slots.back();
+                        free_slots.pop_back();
+                        auto& sl = slots[s];
+                        sl.file = index;
+                        sl.offset = file->submit_offset;
+                        sl.length = static_cast<std::size_t>((std::min)(std::uint64_t(chunk_size), file->size - file->submit_offset));
+                        sl.result = 0;
+                        file->submit_offset += sl.length;
+                        ++file->in_flight;
+
+                        sqe->opcode = fixed_buffers ? IORING_OP_READ_FIXED : IORING_OP_READV;
+                        sqe->fd = fixed_files ? static_cast<int>(index) : file->fd.get();
+                        sqe->flags = fixed_files ? IOSQE_FIXED_FILE : 0;
+                        sqe->off = sl.offset;
+                        if (fixed_buffers) {
+                            sqe->addr = reinterpret_cast<std::uint64_t>(sl.iov.iov_base);
+                            sqe->len = static_cast<std::uint32_t>(sl.length);
+                            sqe->buf_index = static_cast<std::uint16_t>(s);
+                        }
+                        else {
+                            sl.iov.iov_len = sl.length;
+                            sqe->addr = reinterpret_cast<std::uint64_t>(&sl.iov);
+                            sqe->len = 1;
+                        }
+                        sqe->user_data = s;
+                        ++submitted;
+                        queued = true;
+                    }
+                }
+
+                bool any_in_flight = submitted > 0;
+                for (auto& file : files) {
+                    if (file && file->in_flight > 0) any_in_flight = true;
+                }
+                if (!any_in_flight) {
+                    // nothing left to read, the remaining open files only have to be drained
+                    for (std::size_t i = 0; i < max_open_files; ++i) {
+                        if (files[i]) drain(i);
+                    }
+                    continue;
+                }
+
+                auto error = ring.submit_and_wait(1);
+                if (error == EAGAIN || error == EBUSY) {
+                    // backpressure, the requests left are submitted again once completions have been reaped
+                    if (reap() == 0) std::this_thread::yield();
+                    continue;
+                }
+                if (error != 0) {
+                    // the ring is unusable, once no read can write to the buffers anymore the open files and the files
+                    // not opened yet are hashed synchronously.
+                    if (!ring.wait_in_flight()) {
+                        // the reads may still be running, the buffers are leaked rather than unmapped under them
+                        static_cast<void>(new aligned_buffer{std::move(arena)});
+                    }
+                    for (std::size_t i = 0; i < max_open_files; ++i) {
+                        if (!files[i]) continue;
+                        auto path_index = files[i]->index;
+                        files[i].reset();
+                        std::error_code ec;
+                        auto ctx = hash_file<Algo>(paths[path_index], ec);
+                        on_complete(path_index, ctx, ec);
+                    }
+                    for (; next_path < paths.size(); ++next_path) {
+                        std::error_code ec;
+                        auto ctx = hash_file<Algo>(paths[next_path], ec);
+                        on_complete(next_path, ctx, ec);
+                    }
+                    break;
+                }
+                reap();
+            }
+            return true;
+        }
+#endif
+    }
+
+    // hashes every file of `paths` and calls `on_complete(index, ctx, ec)` as soon as the file `paths[index]` has been
+    // hashed, which happens in no particular order. on linux the reads of all files are issued through an io_uring with
+    // registered buffers and files, elsewhere or when io_uring is unavailable the files are hashed one after another.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Callback>
+    auto hash_files_batch(const std::vector<std::string>& paths, Callback&& on_complete, const batch_options& options = {}) -> void {
+#if HASHLIB_HAS_IO_URING
+        if (detail::hash_files_uring<Algo>(paths, on_complete, options)) return;
+#else
+        (void)options;
+#endif
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            std::error_code ec;
+            auto ctx = hash_file<Algo>(paths[i], ec);
+            on_complete(i, ctx, ec);
+        }
+    }
+}
@@ -42,6 +42,12 @@
 #error "hashlib requires the C++ compiler is clang, gcc or msvc."
 #endif
 
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define HASHLIB_PLATFORM_POSIX 1
+#else
+#define HASHLIB_PLATFORM_POSIX 0
+#endif
+
 #if HASHLIB_CXX_COMPILER_CLANG
 #define HASHLIB_ALWAYS_INLINE [[clang::always_inline]]
 #elif HASHLIB_CXX_COMPILER_GCC
@@ -50,6 +56,12 @@
 #define HASHLIB_ALWAYS_INLINE [[msvc::forceinline]]
 #endif
 
+#if HASHLIB_CXX_COMPILER_CLANG || HASHLIB_CXX_COMPILER_GCC
+#define HASHLIB_NOINLINE [[gnu::noinline]]
+#elif HASHLIB_CXX_COMPILER_MSVC
+#define HASHLIB_NOINLINE __declspec(noinline)
+#endif
+
 #ifdef HASHLIB_BUILD_MODULE
 #define HASHLIB_MOD_EXPORT export
 #define HASHLIB_MOD_EXPORT_BEGIN export {
@@ -0,0 +1,77 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASHLIB_HAS_STREAMING_STORES 1
+#else
+#define HASHLIB_HAS_STREAMING_STORES 0
+#endif
+
+namespace hashlib {
+    HASHLIB_MOD_EXPORT enum class copy_hint {
+        // non-temporal stores for copies of at least `copy_streaming_threshold` bytes.
+        automatic,
+        // plain stores, the destination stays in the cache.
+        cached,
+        // non-temporal stores, the destination bypasses the cache, where supported.
+        streaming
+    };
+
+    // copies of this size or more are unlikely to be read back from the cache.
+    HASHLIB_MOD_EXPORT HASHLIB_CXX17_INLINE constexpr std::size_t copy_streaming_threshold = std::size_t(4) << 20;
+
+    namespace detail {
+        // a chunk is hashed first, which brings it into the l1 cache, and then copied from there.
+        HASHLIB_CXX17_INLINE constexpr std::size_t copy_chunk_size = 8192;
+
+        inline auto copy_streaming(byte* dst, const byte* src, std::size_t n) noexcept -> void {
+#if HASHLIB_HAS_STREAMING_STORES
+            auto head = (16 - reinterpret_cast<std::uintptr_t>(dst) % 16) % 16;
+            head = (std::min)(head, n);
+            std::memcpy(dst, src, head);
+            std::size_t i = head;
+            for (; i + 64 <= n; i += 64) {
+                auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+                auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+                auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+                _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), a);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), b);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), c);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), d);
+            }
+            std::memcpy(dst + i, src + i, n - i);
+#else
+            std::memcpy(dst, src, n);
+#endif
+        }
+    }
+
+    // copies `n` bytes from `src` to `dst` and hashes them into `ctx`, reading every byte from memory only once.
+    // the ranges shall not overlap.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    auto copy_and_hash(void* dst, const void* src, std::size_t n, Algo& ctx, copy_hint hint = copy_hint::automatic) -> void {
+        auto out = static_cast<byte*>(dst);
+        auto in = static_cast<const byte*>(src);
+        bool streaming = hint == copy_hint::streaming || (hint == copy_hint::automatic && n >= copy_streaming_threshold);
+        for (std::size_t i = 0; i < n;) {
+            auto chunk = (std::min)(n - i, std::size_t(detail::copy_chunk_size));
+            ctx.update({in + i, chunk});
+            if (streaming) {
+                detail::copy_streaming(out + i, in + i, chunk);
+            } else {
+                std::memcpy(out + i, in + i, chunk);
+            }
+            i += chunk;
+        }
+#if HASHLIB_HAS_STREAMING_STORES
+        // the streaming stores are weakly ordered, they shall be visible before the destination is handed over
+        if (streaming) _mm_sfence();
+#endif
+    }
+}
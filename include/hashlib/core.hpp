@@ -10,11 +10,17 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #endif
 
 
@@ -58,6 +64,20 @@ namespace hashlib {
         template<typename T>
         using type_identity_t = typename type_identity<T>::type;
 
+        template<std::size_t... Is>
+        struct index_sequence {};
+
+        template<std::size_t N, std::size_t... Is>
+        struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, Is...> {};
+
+        template<std::size_t... Is>
+        struct make_index_sequence_impl<0, Is...> {
+            using type = index_sequence<Is...>;
+        };
+
+        template<std::size_t N>
+        using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
         template<typename...>
         struct conjunction : std::true_type {};
 
@@ -390,6 +410,12 @@ namespace hashlib {
         return {reinterpret_cast<byte*>(s.data()), s.size_bytes()};
     }
 
+    // customization point for iterators over chunked storage, e.g. `std::deque`.
+    // a specialization provides `static auto segment_remaining(const Iterator& it) -> std::size_t` which returns the
+    // number of elements that are stored contiguously starting from `it` up to the end of the segment `it` points into.
+    // the iterators of `std::deque` of bytes are segmented without a specialization, see `deque_segment_size`.
+    HASHLIB_MOD_EXPORT template<typename Iterator, typename = void>
+    struct segmented_iterator_traits {};
 
     namespace detail {
         template<typename T>
@@ -426,15 +452,357 @@ namespace hashlib {
 #endif
         >;
 
+        template<typename It, typename = void>
+        struct is_contiguous_iterator_impl : std::is_pointer<It> {};
+
+        // there is no way to detect contiguity before C++20, so only the standard iterators known to be contiguous are
+        // recognized, they are enough to cover `std::vector` and `std::string` which are the common cases.
+        template<typename It>
+        struct is_contiguous_iterator_impl<It, enable_if_t<
+            !std::is_pointer<It>::value &&
+            is_byte_like<iter_value_t<It>>::value
+        >> : disjunction<
+            std::is_same<It, typename std::vector<iter_value_t<It>>::iterator>,
+            std::is_same<It, typename std::vector<iter_value_t<It>>::const_iterator>,
+            std::is_same<It, std::string::iterator>,
+            std::is_same<It, std::string::const_iterator>
+#ifdef __cpp_lib_concepts
+            ,bool_constant<std::contiguous_iterator<It>>
+#endif
+        > {};
+
+        template<typename T>
+        using is_contiguous_iterator = is_contiguous_iterator_impl<T>;
+
+        // the number of elements of a node of `std::deque<T>` in the standard library, 0 when it is unknown.
+        template<typename T>
+        constexpr auto deque_node_size() noexcept -> std::size_t {
+#if defined(__GLIBCXX__)
+            return sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+#elif defined(_LIBCPP_VERSION)
+            return sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+#elif defined(_MSVC_STL_VERSION)
+            return sizeof(T) <= 1 ? 16 : sizeof(T) <= 2 ? 8 : sizeof(T) <= 4 ? 4 : sizeof(T) <= 8 ? 2 : 1;
+#else
+            return 0;
+#endif
+        }
+
+        template<typename It, typename = void>
+        struct is_deque_iterator : std::false_type {};
+
+        template<typename It>
+        struct is_deque_iterator<It, enable_if_t<
+            is_byte_like<iter_value_t<It>>::value && (deque_node_size<iter_value_t<It>>() > 0)
+        >> : bool_constant<
+            std::is_same<It, typename std::deque<iter_value_t<It>>::iterator>::value ||
+            std::is_same<It, typename std::deque<iter_value_t<It>>::const_iterator>::value
+        > {};
+
+        template<typename It>
+        auto element_address(const It& it, std::size_t i) noexcept -> std::uintptr_t {
+            return reinterpret_cast<std::uintptr_t>(std::addressof(*(it + static_cast<typename std::iterator_traits<It>::difference_type>(i))));
+        }
+
+        // the number of elements stored contiguously from `first`, at most `count`, through the public interface of
+        // the deque. the node of `first` ends within `deque_node_size` elements, so the elements up to there span at
+        // most two nodes, and element `i` is in the node of `first` exactly when it is `i` elements after it in memory.
+        // a binary search finds the end of the node. nodes which happen to be adjacent are read as one run of bytes.
+        template<typename DequeIt>
+        auto deque_segment_size(const DequeIt& first, std::size_t count) noexcept -> std::size_t {
+            using value_type = iter_value_t<DequeIt>;
+            const auto base = element_address(first, 0);
+            std::size_t lo = 1;
+            std::size_t hi = (std::min)(count, deque_node_size<value_type>());
+            if (element_address(first, hi - 1) == base + (hi - 1) * sizeof(value_type)) return hi;
+            while (hi - lo > 1) {
+                auto mid = lo + (hi - lo) / 2;
+                if (element_address(first, mid - 1) == base + (mid - 1) * sizeof(value_type)) lo = mid;
+                else hi = mid;
+            }
+            return lo;
+        }
+
+        template<typename It, typename = void>
+        struct has_segmented_iterator_traits : std::false_type {};
+
+        template<typename It>
+        struct has_segmented_iterator_traits<It, enable_if_t<
+            std::is_convertible<
+                decltype(segmented_iterator_traits<It>::segment_remaining(std::declval<const It&>())),
+                std::size_t
+            >::value
+        >> : std::true_type {};
+
+        template<typename It>
+        using is_segmented_iterator = bool_constant<
+            is_random_access_iterator<It>::value &&
+            !is_contiguous_iterator<It>::value &&
+            (has_segmented_iterator_traits<It>::value || is_deque_iterator<It>::value)
+        >;
+
+        template<typename SegmentedIt, enable_if_t<has_segmented_iterator_traits<SegmentedIt>::value>* = nullptr>
+        auto segment_size(const SegmentedIt& first, std::size_t count) noexcept -> std::size_t {
+            return (std::min)(count, static_cast<std::size_t>(segmented_iterator_traits<SegmentedIt>::segment_remaining(first)));
+        }
+
+        template<typename SegmentedIt, enable_if_t<!has_segmented_iterator_traits<SegmentedIt>::value>* = nullptr>
+        auto segment_size(const SegmentedIt& first, std::size_t count) noexcept -> std::size_t {
+            return deque_segment_size(first, count);
+        }
+
+        template<typename ContiguousIt>
+        auto contiguous_bytes(ContiguousIt first, std::size_t count) noexcept -> span<const byte> {
+            static_assert(is_contiguous_iterator<ContiguousIt>::value, "unexpected");
+            if (count == 0) return {};
+            return {reinterpret_cast<const byte*>(std::addressof(*first)), count};
+        }
+
+        HASHLIB_ALWAYS_INLINE
+        inline auto byteswap32(std::uint32_t x) noexcept -> std::uint32_t {
+#if HASHLIB_CXX_COMPILER_MSVC
+            return _byteswap_ulong(x);
+#else
+            return __builtin_bswap32(x);
+#endif
+        }
+
+        HASHLIB_ALWAYS_INLINE
+        inline auto byteswap64(std::uint64_t x) noexcept -> std::uint64_t {
+#if HASHLIB_CXX_COMPILER_MSVC
+            return _byteswap_uint64(x);
+#else
+            return __builtin_bswap64(x);
+#endif
+        }
+
+        HASHLIB_ALWAYS_INLINE
+        inline auto load_le32(const byte* ptr) noexcept -> std::uint32_t {
+            std::uint32_t x;
+            std::memcpy(&x, ptr, sizeof(x));
+            return is_little_endian() ? x : byteswap32(x);
+        }
+
+        HASHLIB_ALWAYS_INLINE
+        inline auto load_be32(const byte* ptr) noexcept -> std::uint32_t {
+            std::uint32_t x;
+            std::memcpy(&x, ptr, sizeof(x));
+            return is_little_endian() ? byteswap32(x) : x;
+        }
+
+        HASHLIB_ALWAYS_INLINE
+        inline auto load_le64(const byte* ptr) noexcept -> std::uint64_t {
+            std::uint64_t x;
+            std::memcpy(&x, ptr, sizeof(x));
+            return is_little_endian() ? x : byteswap64(x);
+        }
+
+        HASHLIB_ALWAYS_INLINE
+        inline auto load_be64(const byte* ptr) noexcept -> std::uint64_t {
+            std::uint64_t x;
+            std::memcpy(&x, ptr, sizeof(x));
+            return is_little_endian() ? byteswap64(x) : x;
+        }
+
         HASHLIB_CXX17_INLINE constexpr char hex_table[] = "0123456789abcdef";
+
+        inline auto to_hex(span<const byte> bytes) -> std::string {
+            std::string result;
+            result.resize(2 * bytes.size());
+            std::size_t i = 0;
+            for (auto byte_ : bytes) {
+                result[i++] = hex_table[byte_ / 16];
+                result[i++] = hex_table[byte_ % 16];
+            }
+            return result;
+        }
+
+        template<typename Word>
+        auto put_le(std::vector<byte>& out, Word word) -> void {
+            for (std::size_t i = 0; i < sizeof(Word); ++i) {
+                out.push_back(static_cast<byte>(word >> (8 * i)));
+            }
+        }
+
+        template<typename Word>
+        auto get_le(const byte* in) noexcept -> Word {
+            Word word = 0;
+            for (std::size_t i = 0; i < sizeof(Word); ++i) {
+                word |= static_cast<Word>(in[i]) << (8 * i);
+            }
+            return word;
+        }
+
+        // the padding of a merkle-damgard message of exactly `N` bytes, its layout is known at compile time.
+        // the last block holds no message byte when the message fills whole blocks or when the length does not fit
+        // after the tail, such a block is the same for every message and its schedule can be computed once.
+        template<std::size_t N, std::size_t BlockSize, std::size_t LengthSize, bool BigEndian>
+        struct fixed_padding {
+            static constexpr std::size_t full_blocks = N / BlockSize;
+            static constexpr std::size_t tail_size = N % BlockSize;
+            static constexpr bool has_tail_block = tail_size > 0;
+            static constexpr bool has_constant_block = tail_size == 0 || tail_size + 1 + LengthSize > BlockSize;
+
+            // the last `tail_size` bytes of the message followed by the padding.
+            static auto tail_block(const byte* tail) noexcept -> std::array<byte, BlockSize> {
+                std::array<byte, BlockSize> block{};
+                std::copy_n(tail, tail_size, block.data());
+                block[tail_size] = 0x80;
+                if (!has_constant_block) put_length_(block.data());
+                return block;
+            }
+
+            static auto constant_block() noexcept -> std::array<byte, BlockSize> {
+                std::array<byte, BlockSize> block{};
+                if (tail_size == 0) block[0] = 0x80;
+                put_length_(block.data());
+                return block;
+            }
+
+        private:
+            static auto put_length_(byte* block) noexcept -> void {
+                std::uint64_t bits = static_cast<std::uint64_t>(N) * 8;
+                for (std::size_t i = 0; i < 8; ++i) {
+                    block[BigEndian ? BlockSize - 1 - i : BlockSize - LengthSize + i] = static_cast<byte>(bits >> (8 * i));
+                }
+            }
+        };
+
+        // a write-only streambuf which forwards everything written to it to `Context::update`.
+        template<typename Context, typename CharT, typename Traits>
+        class update_streambuf : public std::basic_streambuf<CharT, Traits> {
+            static_assert(is_byte_like<CharT>::value, "unexpected");
+        public:
+            using int_type = typename Traits::int_type;
+
+        public:
+            explicit update_streambuf(Context& ctx) noexcept : ctx_(ctx) {
+                this->setp(buffer_, buffer_ + sizeof(buffer_));
+            }
+
+            update_streambuf(const update_streambuf&) = delete;
+
+            auto operator= (const update_streambuf&) -> update_streambuf& = delete;
+
+        protected:
+            auto overflow(int_type ch) -> int_type override {
+                flush_();
+                if (!Traits::eq_int_type(ch, Traits::eof())) {
+                    *this->pptr() = Traits::to_char_type(ch);
+                    this->pbump(1);
+                }
+                return Traits::not_eof(ch);
+            }
+
+            auto xsputn(const CharT* s, std::streamsize count) -> std::streamsize override {
+                flush_();
+                ctx_.update({reinterpret_cast<const byte*>(s), static_cast<std::size_t>(count)});
+                return count;
+            }
+
+            auto sync() -> int override {
+                flush_();
+                return 0;
+            }
+
+        private:
+            auto flush_() -> void {
+                ctx_.update({reinterpret_cast<const byte*>(this->pbase()), static_cast<std::size_t>(this->pptr() - this->pbase())});
+                this->setp(buffer_, buffer_ + sizeof(buffer_));
+            }
+
+        private:
+            Context& ctx_;
+            CharT buffer_[4096];
+        };
     }
 
+    // the state of a context after a prefix of whole blocks, see `context::midstate`.
+    HASHLIB_MOD_EXPORT template<typename State>
+    struct basic_midstate {
+        State state;
+        // the number of bytes hashed, a multiple of the block size.
+        std::uint64_t size;
+    };
+
+    // the version of the format written by `context::export_state`.
+    HASHLIB_MOD_EXPORT HASHLIB_CXX17_INLINE constexpr byte state_format_version = 1;
+
+    namespace detail {
+        struct no_midstate {};
+
+        template<typename Base, typename = void>
+        struct midstate_of {
+            using type = no_midstate;
+        };
+
+        template<typename Base>
+        struct midstate_of<Base, void_t<typename Base::state_type>> {
+            using type = basic_midstate<typename Base::state_type>;
+        };
+
+        template<typename Base, typename = void>
+        struct block_size_of : std::integral_constant<std::size_t, 0> {};
+
+        template<typename Base>
+        struct block_size_of<Base, void_t<decltype(Base::block_size)>> : std::integral_constant<std::size_t, Base::block_size> {};
+
+        // the kernel which compresses a block of several independent streams of `Algo` at once, see `context_pool`.
+        // `type` has the number of `lanes`, the `word_type` of the state and `compress(state, blocks)`, where `state`
+        // holds word `j` of lane `l` at `j * lanes + l` and `blocks[l]` is the block of lane `l`. `pad(tail, tail_size,
+        // size, blocks)` writes the at most `max_padding_blocks` last blocks of a message and `store_word(word, out)`
+        // writes a word of the final state to the digest. `void` if there is none.
+        template<typename Algo, typename = void>
+        struct lane_kernel {
+            using type = void;
+        };
+
+        template<typename Algo>
+        using has_lane_kernel = bool_constant<!std::is_void<typename lane_kernel<Algo>::type>::value>;
+
+        // the number of messages given to the lanes at once.
+        HASHLIB_CXX17_INLINE constexpr std::size_t lanes_batch = 64;
+
+        template<typename Message>
+        using is_message = conjunction<is_contiguous_range<const Message>, is_byte_like<range_value_t<const Message>>>;
+
+        template<typename Message>
+        auto message_bytes(const Message& message) noexcept -> span<const byte> {
+            return {
+                reinterpret_cast<const byte*>(detail::data(message)),
+                static_cast<std::size_t>(std::end(message) - std::begin(message))
+            };
+        }
+
+        // the partial block of an algorithm which buffers its input, see `context::put`: the buffer of `block_size`
+        // bytes, the number of bytes in it and the number of bytes hashed.
+        struct partial_block {
+            byte* data;
+            std::size_t& size;
+            std::uint64_t& total_size;
+        };
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo, std::size_t N>
+    auto hash_fixed(const byte* data) noexcept -> std::array<byte, Algo::digest_size>;
+
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    class context_pool;
 
     HASHLIB_MOD_EXPORT template<typename Base>
-    class context : private Base {
+    class context : protected Base {
+        template<typename Algo, std::size_t N>
+        friend auto hash_fixed(const byte* data) noexcept -> std::array<byte, Algo::digest_size>;
+
+        template<typename Algo>
+        friend class context_pool;
+
     public:
         using Base::digest_size;
         using Base::update;
+        using midstate_type = typename detail::midstate_of<Base>::type;
+
+        static constexpr std::size_t block_size = detail::block_size_of<Base>::value;
 
         context() = default;
 
@@ -457,6 +825,99 @@ namespace hashlib {
         >* = nullptr>
         explicit context(Range&& rng) : context(std::begin(rng), std::end(rng)) {}
 
+        template<typename InputIt, typename Sentinel, detail::enable_if_t<
+            detail::is_input_iterator<InputIt>::value &&
+            !detail::is_random_access_iterator<InputIt>::value &&
+            detail::is_sentinel_for<Sentinel, InputIt>::value &&
+            detail::is_byte_like<detail::iter_value_t<InputIt>>::value
+        >* = nullptr>
+        auto update(InputIt first, Sentinel last) -> void {
+            byte temp[256];
+            for (auto it = first; it != last;) {
+                std::size_t n = 0;
+                for (; it != last && n < sizeof(temp); ++it, ++n) {
+                    temp[n] = static_cast<byte>(*it);
+                }
+                this->update({temp, n});
+            }
+        }
+
+        template<typename RandomAccessIt, typename Sentinel, detail::enable_if_t<
+            detail::is_random_access_iterator<RandomAccessIt>::value &&
+            !detail::is_contiguous_iterator<RandomAccessIt>::value &&
+            !detail::is_segmented_iterator<RandomAccessIt>::value &&
+            detail::is_sentinel_for<Sentinel, RandomAccessIt>::value &&
+            detail::is_byte_like<detail::iter_value_t<RandomAccessIt>>::value
+        >* = nullptr>
+        auto update(RandomAccessIt first, Sentinel last) -> void {
+            byte temp[256];
+            std::size_t bytes_count = last - first;
+            while (bytes_count > 0) {
+                std::size_t n = std::min(bytes_count, sizeof(temp));
+                std::copy_n(first, n, temp);
+                first += n;
+                bytes_count -= n;
+                this->update({temp, n});
+            }
+        }
+
+        template<typename SegmentedIt, typename Sentinel, detail::enable_if_t<
+            detail::is_segmented_iterator<SegmentedIt>::value &&
+            detail::is_sentinel_for<Sentinel, SegmentedIt>::value &&
+            detail::is_byte_like<detail::iter_value_t<SegmentedIt>>::value
+        >* = nullptr>
+        auto update(SegmentedIt first, Sentinel last) -> void {
+            std::size_t bytes_count = last - first;
+            while (bytes_count > 0) {
+                std::size_t n = detail::segment_size(first, bytes_count);
+                assert(n > 0);
+                this->update({reinterpret_cast<const byte*>(std::addressof(*first)), n});
+                first += n;
+                bytes_count -= n;
+            }
+        }
+
+        template<typename ContiguousIt, typename Sentinel, detail::enable_if_t<
+            detail::is_contiguous_iterator<ContiguousIt>::value &&
+            detail::is_sentinel_for<Sentinel, ContiguousIt>::value &&
+            detail::is_byte_like<detail::iter_value_t<ContiguousIt>>::value
+        >* = nullptr>
+        auto update(ContiguousIt first, Sentinel last) -> void {
+            this->update(detail::contiguous_bytes(first, last - first));
+        }
+
+        // the standard library can copy between stream buffers a whole get area at a time, so the characters are
+        // routed through a streambuf which forwards them to `update` instead of being staged one by one.
+        template<typename CharT, typename Traits, detail::enable_if_t<
+            detail::is_byte_like<CharT>::value
+        >* = nullptr>
+        auto update(std::istreambuf_iterator<CharT, Traits> first, std::istreambuf_iterator<CharT, Traits> last) -> void {
+            detail::update_streambuf<context, CharT, Traits> sink{*this};
+            std::copy(first, last, std::ostreambuf_iterator<CharT, Traits>{&sink});
+            sink.pubsync();
+        }
+
+        template<typename CharT, typename Traits, detail::enable_if_t<
+            detail::is_byte_like<CharT>::value
+        >* = nullptr>
+        auto update(std::basic_streambuf<CharT, Traits>& sb) -> void {
+            CharT temp[16384];
+            std::streamsize n;
+            while ((n = sb.sgetn(temp, sizeof(temp))) > 0) {
+                this->update({reinterpret_cast<const byte*>(temp), static_cast<std::size_t>(n)});
+            }
+        }
+
+        template<typename CharT, typename Traits, detail::enable_if_t<
+            detail::is_byte_like<CharT>::value
+        >* = nullptr>
+        auto update(std::basic_istream<CharT, Traits>& is) -> void {
+            typename std::basic_istream<CharT, Traits>::sentry sentry{is, true};
+            if (!sentry) return;
+            this->update(*is.rdbuf());
+            is.setstate(is.eofbit);
+        }
+
         template<typename Range, detail::enable_if_t<
             detail::is_input_range<Range>::value &&
             detail::is_byte_like<detail::range_value_t<Range>>::value
@@ -465,35 +926,129 @@ namespace hashlib {
             this->update(std::begin(rng), std::end(rng));
         }
 
+        // a few bytes at a time, e.g. the fields of a serialized message. they are copied straight into the partial
+        // block without the dispatch of `update`, which they reach only when the block fills. an algorithm exposes its
+        // block through `do_partial_block()`, or provides `do_put` if it has none, e.g. sha3 absorbs into its state.
+        HASHLIB_ALWAYS_INLINE auto put(span<const byte> bytes) noexcept -> void {
+            put_(bytes.data(), bytes.size(), 0);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u8(std::uint8_t value) noexcept -> void {
+            const byte bytes[1] = {value};
+            put_(bytes, 1, 0);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u16_le(std::uint16_t value) noexcept -> void {
+            put_le_(value);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u16_be(std::uint16_t value) noexcept -> void {
+            put_be_(value);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u32_le(std::uint32_t value) noexcept -> void {
+            put_le_(value);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u32_be(std::uint32_t value) noexcept -> void {
+            put_be_(value);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u64_le(std::uint64_t value) noexcept -> void {
+            put_le_(value);
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_u64_be(std::uint64_t value) noexcept -> void {
+            put_be_(value);
+        }
+
         HASHLIB_NODISCARD auto digest() noexcept -> std::array<byte, digest_size> {
-            std::array<byte, digest_size> result;
-            std::size_t i = 0;
-            static_assert(digest_size <= sizeof(decltype(this->do_digest())), "what the f**k?");
-            for (auto unit : this->do_digest()) {
-                if (i == digest_size) break;
-                for (auto byte_ : this->unit_to_bytes(unit)) {
-                    result[i++] = byte_;
-                }
-            }
-            assert(i == digest_size);
-            return result;
+            return to_digest_(this->do_digest());
         }
 
         HASHLIB_NODISCARD auto hexdigest() -> std::string {
-            std::string result;
-            result.resize(2 * digest_size);
-            std::size_t i = 0;
-            for (auto byte_ : digest()) {
-                result[i++] = detail::hex_table[byte_ / 16];
-                result[i++] = detail::hex_table[byte_ % 16];
-            }
-            return result;
+            auto result = digest();
+            return detail::to_hex({result.data(), result.size()});
         }
 
         HASHLIB_CXX17_CONSTEXPR auto clear() noexcept -> void {
             *this = context{};
         }
 
+        // true when the bytes hashed so far fill whole blocks, which is when `midstate()` can be taken.
+        HASHLIB_NODISCARD auto at_block_boundary() const noexcept -> bool {
+            return (this->do_midstate().size + this->do_buffered().size()) % Base::block_size == 0;
+        }
+
+        // the chaining state after a prefix of whole blocks, e.g. a fixed header padded to the block size, it is much
+        // smaller than the context. throws `std::logic_error` unless `at_block_boundary()`.
+        HASHLIB_NODISCARD auto midstate() const -> midstate_type {
+            if (!at_block_boundary()) throw std::logic_error{"hashlib: the midstate is only defined at a block boundary"};
+            return this->do_midstate();
+        }
+
+        // the context which continues from `state`. throws `std::invalid_argument` if its size is not a multiple of
+        // the block size.
+        HASHLIB_NODISCARD static auto from_midstate(const midstate_type& state) -> context {
+            if (state.size % Base::block_size != 0) throw std::invalid_argument{"hashlib: the midstate is not at a block boundary"};
+            context result;
+            result.do_load_midstate(state);
+            return result;
+        }
+
+        // a compact image of the context, which `import_state` resumes from on any machine, e.g. when a long upload is
+        // hashed across several processes. its layout does not depend on the platform: the format version, the digest
+        // size and the block size as single bytes, the number of bytes hashed as 64 bits little endian, the words of
+        // the state little endian, then the bytes of the partial block unless the state already holds them.
+        HASHLIB_NODISCARD auto export_state() const -> std::vector<byte> {
+            auto state = this->do_midstate();
+            auto buffered = this->do_buffered();
+            std::vector<byte> result;
+            result.reserve(state_header_size_ + sizeof(state.state) + buffered.size());
+            result.push_back(state_format_version);
+            result.push_back(static_cast<byte>(digest_size));
+            result.push_back(static_cast<byte>(Base::block_size));
+            detail::put_le(result, static_cast<std::uint64_t>(state.size + buffered.size()));
+            for (auto word : state.state) detail::put_le(result, word);
+            result.insert(result.end(), buffered.begin(), buffered.end());
+            return result;
+        }
+
+        // replaces the state by the one exported by `export_state`, hashing continues from the exact byte where it
+        // stopped. throws `std::invalid_argument` if `image` is not the state of this algorithm in a known format.
+        auto import_state(span<const byte> image) -> void {
+            midstate_type state;
+            using word_type = typename std::remove_reference<decltype(state.state[0])>::type;
+            const std::size_t state_size = state.state.size() * sizeof(word_type);
+            if (
+                image.size() < state_header_size_ + state_size || image[0] != state_format_version ||
+                image[1] != digest_size || image[2] != Base::block_size
+            ) {
+                throw std::invalid_argument{"hashlib: the state was not exported by this algorithm"};
+            }
+            auto size = detail::get_le<std::uint64_t>(image.data() + 3);
+            auto buffered = image.size() - state_header_size_ - state_size;
+            for (std::size_t i = 0; i < state.state.size(); ++i) {
+                state.state[i] = detail::get_le<word_type>(image.data() + state_header_size_ + i * sizeof(word_type));
+            }
+            state.size = size - buffered;
+            context result;
+            if (buffered >= Base::block_size || buffered > size || !result.do_load_midstate(state)) {
+                throw std::invalid_argument{"hashlib: the size of the state is wrong"};
+            }
+            result.update({image.data() + state_header_size_ + state_size, buffered});
+            *this = result;
+        }
+
+        // a context which continues from the same point, only the chaining state and the bytes of the partial block
+        // are copied.
+        HASHLIB_NODISCARD auto fork() const noexcept -> context {
+            context result;
+            result.do_load_midstate(this->do_midstate());
+            result.update(this->do_buffered());
+            return result;
+        }
+
         template<typename Range, detail::enable_if_t<
             detail::is_input_range<Range>::value &&
             detail::is_byte_like<detail::range_value_t<Range>>::value
@@ -502,5 +1057,138 @@ namespace hashlib {
             this->update(std::forward<Range>(rng));
             return *this;
         }
+
+    private:
+        template<typename Self = context>
+        HASHLIB_ALWAYS_INLINE auto put_(const byte* data, std::size_t n, int) noexcept
+            -> decltype(&Self::do_partial_block, void()) {
+            auto block = this->do_partial_block();
+            if (n < block_size - block.size) {
+                block.total_size += n;
+                std::memcpy(block.data + block.size, data, n);
+                block.size += n;
+            }
+            else {
+                put_block_(data, n);
+            }
+        }
+
+        // the write completes the block. out of line, so that the registers of the block function are not saved
+        // wherever `put` is inlined.
+        HASHLIB_NOINLINE auto put_block_(const byte* data, std::size_t n) noexcept -> void {
+            this->update({data, n});
+        }
+
+        HASHLIB_ALWAYS_INLINE auto put_(const byte* data, std::size_t n, long) noexcept -> void {
+            this->do_put(data, n);
+        }
+
+        template<typename Word>
+        HASHLIB_ALWAYS_INLINE auto put_le_(Word value) noexcept -> void {
+            byte bytes[sizeof(Word)];
+            if HASHLIB_CXX17_CONSTEXPR (detail::is_little_endian()) {
+                std::memcpy(bytes, &value, sizeof(Word));
+            }
+            else {
+                for (std::size_t i = 0; i < sizeof(Word); ++i) bytes[i] = static_cast<byte>(value >> (8 * i));
+            }
+            put_(bytes, sizeof(Word), 0);
+        }
+
+        template<typename Word>
+        HASHLIB_ALWAYS_INLINE auto put_be_(Word value) noexcept -> void {
+            byte bytes[sizeof(Word)];
+            for (std::size_t i = 0; i < sizeof(Word); ++i) bytes[sizeof(Word) - 1 - i] = static_cast<byte>(value >> (8 * i));
+            put_(bytes, sizeof(Word), 0);
+        }
+
+        // the version, the digest size, the block size and the number of bytes hashed.
+        static constexpr std::size_t state_header_size_ = 3 + 8;
+
+        template<typename Units>
+        static auto to_digest_(const Units& units) noexcept -> std::array<byte, digest_size> {
+            std::array<byte, digest_size> result;
+            std::size_t i = 0;
+            static_assert(digest_size <= sizeof(Units), "what the f**k?");
+            for (auto unit : units) {
+                if (i == digest_size) break;
+                for (auto byte_ : Base::unit_to_bytes(unit)) {
+                    result[i++] = byte_;
+                }
+            }
+            assert(i == digest_size);
+            return result;
+        }
     };
+
+    template<typename Base>
+    constexpr std::size_t context<Base>::block_size;
+
+    // the digest of exactly `N` bytes, e.g. `hashlib::hash_fixed<hashlib::sha256, 64>(node_pair)`.
+    // the number of blocks and the padding are known at compile time, so there is no buffering and the schedule of a
+    // padding block without message bytes is computed only once. the digest is the same as the one of the context.
+    HASHLIB_MOD_EXPORT template<typename Algo, std::size_t N>
+    HASHLIB_NODISCARD auto hash_fixed(const byte* data) noexcept -> std::array<byte, Algo::digest_size> {
+        Algo ctx;
+        return Algo::to_digest_(ctx.template do_hash_fixed<N>(data));
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo, std::size_t N>
+    HASHLIB_NODISCARD auto hash_fixed(const std::array<byte, N>& data) noexcept -> std::array<byte, Algo::digest_size> {
+        return hash_fixed<Algo, N>(data.data());
+    }
+
+    namespace detail {
+        template<typename Algo, typename Range>
+        auto hash_suffixes(const Algo& prefix, const Range& suffixes, std::false_type) -> std::vector<std::array<byte, Algo::digest_size>> {
+            std::vector<std::array<byte, Algo::digest_size>> result;
+            for (const auto& suffix : suffixes) {
+                auto ctx = prefix.fork();
+                ctx.update(suffix);
+                result.push_back(ctx.digest());
+            }
+            return result;
+        }
+
+        // every suffix is a stream of a `context_pool` seeded with the prefix, so that the suffixes and their padding
+        // are compressed several at a time on the lanes.
+        template<typename Algo, typename Range>
+        auto hash_suffixes(const Algo& prefix, const Range& suffixes, std::true_type) -> std::vector<std::array<byte, Algo::digest_size>> {
+            std::vector<std::array<byte, Algo::digest_size>> result;
+            context_pool<Algo> pool{lanes_batch};
+            std::vector<typename context_pool<Algo>::write> writes;
+            std::vector<typename context_pool<Algo>::handle> handles;
+            auto first = std::begin(suffixes);
+            auto last = std::end(suffixes);
+            while (first != last) {
+                writes.clear();
+                for (; first != last && writes.size() < lanes_batch; ++first) {
+                    writes.push_back({pool.open(prefix), message_bytes(*first)});
+                }
+                pool.update({writes.data(), writes.size()});
+                handles.clear();
+                for (const auto& w : writes) handles.push_back(w.stream);
+                result.resize(result.size() + handles.size());
+                pool.digests({handles.data(), handles.size()}, result.data() + result.size() - handles.size());
+                for (auto stream : handles) pool.close(stream);
+            }
+            return result;
+        }
+    }
+
+    // the digests of `prefix + suffix` for every suffix of the range `suffixes`, the prefix being hashed once by the
+    // context `prefix`. e.g. `hashlib::hash_suffixes(header_ctx, messages)`. when the algorithm has a multi-buffer
+    // kernel and the suffixes are contiguous bytes, several suffixes are hashed at a time, see `context_pool`.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Range>
+    HASHLIB_NODISCARD auto hash_suffixes(const Algo& prefix, const Range& suffixes) -> std::vector<std::array<byte, Algo::digest_size>> {
+        return detail::hash_suffixes(prefix, suffixes, detail::bool_constant<
+            detail::has_lane_kernel<Algo>::value && detail::is_message<detail::range_value_t<const Range>>::value
+        >{});
+    }
+
+    // the same from the midstate of the prefix, e.g. `hashlib::hash_suffixes<hashlib::sha256>(state, messages)`.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Range>
+    HASHLIB_NODISCARD auto hash_suffixes(const typename Algo::midstate_type& prefix, const Range& suffixes) -> std::vector<std::array<byte, Algo::digest_size>> {
+        return hash_suffixes(Algo::from_midstate(prefix), suffixes);
+    }
 }
\ No newline at end of file
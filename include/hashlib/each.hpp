@@ -0,0 +1,197 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include "executor.hpp"
+#include "pool.hpp"
+#include <exception>
+#include <mutex>
+#endif
+
+namespace hashlib {
+    // the execution policies of `hash_each`, in the spirit of `std::execution`.
+    namespace execution {
+        // one message after another on the calling thread.
+        HASHLIB_MOD_EXPORT struct sequenced_policy {};
+
+        // several messages at a time on the lanes of the multi-buffer kernel of the algorithm, on the calling thread.
+        // the algorithms without such a kernel hash one message after another.
+        HASHLIB_MOD_EXPORT struct unsequenced_policy {};
+
+        // the messages split into tasks run by `executor`, every task hashing its messages with the lanes.
+        HASHLIB_MOD_EXPORT template<typename Executor>
+        struct parallel_unsequenced_executor_policy {
+            Executor executor;
+        };
+
+        // the messages split into tasks run by a `thread_pool` owned by the call, unless they are too few bytes to pay
+        // for the threads. `on(executor)` runs the tasks on `executor` instead, see `is_executor`.
+        HASHLIB_MOD_EXPORT struct parallel_unsequenced_policy {
+            template<typename Executor, detail::enable_if_t<is_executor<Executor>::value>* = nullptr>
+            HASHLIB_NODISCARD auto on(const Executor& executor) const -> parallel_unsequenced_executor_policy<Executor> {
+                return {executor};
+            }
+        };
+
+        HASHLIB_MOD_EXPORT HASHLIB_CXX17_INLINE constexpr sequenced_policy seq{};
+        HASHLIB_MOD_EXPORT HASHLIB_CXX17_INLINE constexpr unsequenced_policy unseq{};
+        HASHLIB_MOD_EXPORT HASHLIB_CXX17_INLINE constexpr parallel_unsequenced_policy par_unseq{};
+    }
+
+    namespace detail {
+        // fewer bytes than this are hashed on the calling thread, as starting the tasks would cost more than it saves.
+        HASHLIB_CXX17_INLINE constexpr std::size_t each_parallel_threshold = std::size_t(1) << 20;
+        // the least number of bytes of a task, a task has more when there are enough bytes for 4 tasks per thread.
+        HASHLIB_CXX17_INLINE constexpr std::size_t each_task_size = std::size_t(256) << 10;
+
+        template<typename Algo, typename It>
+        auto hash_lanes(It first, std::size_t count, std::array<byte, Algo::digest_size>* out, std::false_type) -> void {
+            for (std::size_t i = 0; i < count; ++i, ++first) {
+                out[i] = Algo{message_bytes(*first)}.digest();
+            }
+        }
+
+        template<typename Algo, typename It>
+        auto hash_lanes(It first, std::size_t count, std::array<byte, Algo::digest_size>* out, std::true_type) -> void {
+            context_pool<Algo> pool{(std::min)(count, lanes_batch)};
+            std::vector<typename context_pool<Algo>::write> writes;
+            std::vector<typename context_pool<Algo>::handle> handles;
+            while (count > 0) {
+                auto n = (std::min)(count, lanes_batch);
+                writes.clear();
+                for (std::size_t i = 0; i < n; ++i, ++first) {
+                    writes.push_back({pool.open(), message_bytes(*first)});
+                }
+                pool.update({writes.data(), n});
+                handles.clear();
+                for (const auto& w : writes) handles.push_back(w.stream);
+                pool.digests({handles.data(), n}, out);
+                for (auto stream : handles) pool.close(stream);
+                out += n;
+                count -= n;
+            }
+        }
+
+        template<typename Algo, typename It>
+        auto hash_lanes(It first, std::size_t count, std::array<byte, Algo::digest_size>* out) -> void {
+            hash_lanes<Algo>(first, count, out, has_lane_kernel<Algo>{});
+        }
+
+        template<typename It>
+        auto total_message_size(It first, std::size_t count) noexcept -> std::size_t {
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < count; ++i, ++first) total += message_bytes(*first).size();
+            return total;
+        }
+
+        // consecutive messages of about the same number of bytes per task, every task writes its own part of `out`.
+        template<typename Algo, typename Executor, typename It>
+        auto hash_parallel(const Executor& executor, It first, std::size_t count, std::size_t total, std::array<byte, Algo::digest_size>* out) -> void {
+            auto task_size = (std::max)(total / (4 * executor_concurrency(executor)), each_task_size);
+            std::vector<std::pair<std::size_t, std::size_t>> tasks;
+            std::size_t begin = 0;
+            std::size_t bytes = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                bytes += message_bytes(first[i]).size();
+                if (bytes >= task_size || i + 1 == count) {
+                    tasks.emplace_back(begin, i + 1);
+                    begin = i + 1;
+                    bytes = 0;
+                }
+            }
+
+            task_latch latch{tasks.size()};
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            std::size_t submitted = 0;
+            try {
+                for (const auto& task : tasks) {
+                    executor.execute([first, out, task, &latch, &error_mutex, &error] {
+                        try {
+                            hash_lanes<Algo>(first + task.first, task.second - task.first, out + task.first);
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock{error_mutex};
+                            if (!error) error = std::current_exception();
+                        }
+                        latch.count_down();
+                    });
+                    ++submitted;
+                }
+            } catch (...) {
+                latch.count_down(tasks.size() - submitted);
+                latch.wait();
+                throw;
+            }
+            latch.wait();
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    // writes the digest of every message of `[first, last)` to `out`, in order, e.g.
+    // `hashlib::hash_each<sha256>(hashlib::execution::par_unseq, names.begin(), names.end(), digests.begin())`.
+    // the digests are `std::array<byte, Algo::digest_size>`, the messages are ranges of bytes, contiguous ones but
+    // with the sequenced policy.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename InputIt, typename OutputIt, detail::enable_if_t<
+        detail::is_input_iterator<InputIt>::value &&
+        detail::is_byte_like<detail::range_value_t<const detail::iter_value_t<InputIt>>>::value
+    >* = nullptr>
+    auto hash_each(execution::sequenced_policy, InputIt first, InputIt last, OutputIt out) -> OutputIt {
+        for (; first != last; ++first, ++out) {
+            *out = Algo{*first}.digest();
+        }
+        return out;
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo, typename RandomAccessIt, typename OutputIt, detail::enable_if_t<
+        detail::is_random_access_iterator<RandomAccessIt>::value &&
+        detail::is_message<detail::iter_value_t<RandomAccessIt>>::value
+    >* = nullptr>
+    auto hash_each(execution::unsequenced_policy, RandomAccessIt first, RandomAccessIt last, OutputIt out) -> OutputIt {
+        auto count = static_cast<std::size_t>(last - first);
+        std::vector<std::array<byte, Algo::digest_size>> digests(count);
+        detail::hash_lanes<Algo>(first, count, digests.data());
+        return std::copy(digests.begin(), digests.end(), out);
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Executor, typename RandomAccessIt, typename OutputIt, detail::enable_if_t<
+        detail::is_random_access_iterator<RandomAccessIt>::value &&
+        detail::is_message<detail::iter_value_t<RandomAccessIt>>::value
+    >* = nullptr>
+    auto hash_each(
+        const execution::parallel_unsequenced_executor_policy<Executor>& policy,
+        RandomAccessIt first,
+        RandomAccessIt last,
+        OutputIt out
+    ) -> OutputIt {
+        auto count = static_cast<std::size_t>(last - first);
+        std::vector<std::array<byte, Algo::digest_size>> digests(count);
+        auto total = detail::total_message_size(first, count);
+        if (total < detail::each_parallel_threshold || detail::executor_concurrency(policy.executor) == 1) {
+            detail::hash_lanes<Algo>(first, count, digests.data());
+        }
+        else {
+            detail::hash_parallel<Algo>(policy.executor, first, count, total, digests.data());
+        }
+        return std::copy(digests.begin(), digests.end(), out);
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo, typename RandomAccessIt, typename OutputIt, detail::enable_if_t<
+        detail::is_random_access_iterator<RandomAccessIt>::value &&
+        detail::is_message<detail::iter_value_t<RandomAccessIt>>::value
+    >* = nullptr>
+    auto hash_each(execution::parallel_unsequenced_policy, RandomAccessIt first, RandomAccessIt last, OutputIt out) -> OutputIt {
+        auto count = static_cast<std::size_t>(last - first);
+        if (detail::total_message_size(first, count) < detail::each_parallel_threshold) {
+            return hash_each<Algo>(execution::unseq, first, last, out);
+        }
+        thread_pool pool;
+        return hash_each<Algo>(execution::par_unseq.on(pool.get_executor()), first, last, out);
+    }
+
+    // the digests of every message of `messages`, in order.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Policy, typename Range>
+    HASHLIB_NODISCARD auto hash_each(const Policy& policy, const Range& messages) -> std::vector<std::array<byte, Algo::digest_size>> {
+        std::vector<std::array<byte, Algo::digest_size>> digests;
+        hash_each<Algo>(policy, std::begin(messages), std::end(messages), std::back_inserter(digests));
+        return digests;
+    }
+}
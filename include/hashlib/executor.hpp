@@ -0,0 +1,285 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include "numa.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace hashlib {
+    namespace detail {
+        template<typename, typename = void>
+        struct is_executor_impl : std::false_type {};
+
+        template<typename T>
+        struct is_executor_impl<T, void_t<
+            decltype(std::declval<const T&>().execute(std::declval<std::function<void()>>()))
+        >> : std::true_type {};
+
+        template<typename, typename = void>
+        struct has_concurrency : std::false_type {};
+
+        template<typename T>
+        struct has_concurrency<T, void_t<decltype(std::declval<const T&>().concurrency())>> : std::true_type {};
+
+        template<typename Executor, enable_if_t<has_concurrency<Executor>::value>* = nullptr>
+        auto executor_concurrency(const Executor& executor) -> std::size_t {
+            return (std::max)(static_cast<std::size_t>(executor.concurrency()), std::size_t(1));
+        }
+
+        template<typename Executor, enable_if_t<!has_concurrency<Executor>::value>* = nullptr>
+        auto executor_concurrency(const Executor&) -> std::size_t {
+            return (std::max)(std::thread::hardware_concurrency(), 1u);
+        }
+
+        inline auto current_pool_worker() noexcept -> std::pair<const void*, std::size_t>& {
+            static thread_local std::pair<const void*, std::size_t> worker{nullptr, 0};
+            return worker;
+        }
+
+        // counts the tasks which are still running.
+        class task_latch {
+        public:
+            explicit task_latch(std::size_t count) noexcept : count_(count) {}
+
+            auto count_down(std::size_t n = 1) -> void {
+                std::lock_guard<std::mutex> lock{mutex_};
+                count_ -= n;
+                if (count_ == 0) cv_.notify_all();
+            }
+
+            auto wait() -> void {
+                std::unique_lock<std::mutex> lock{mutex_};
+                cv_.wait(lock, [this] { return count_ == 0; });
+            }
+
+        private:
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            std::size_t count_;
+        };
+    }
+
+    // an executor is a cheap copyable object `ex` such that `ex.execute(f)` runs the nullary callable `f`, eventually and
+    // possibly on another thread. `ex.concurrency()` optionally tells how many tasks it runs at the same time, which the
+    // parallel algorithms use to size their tasks.
+    // the parallel and asynchronous features run on an executor given by the caller, or on a `thread_pool` they own.
+    HASHLIB_MOD_EXPORT template<typename T>
+    using is_executor = detail::is_executor_impl<detail::remove_cvref_t<T>>;
+
+    // runs every task immediately on the calling thread.
+    HASHLIB_MOD_EXPORT struct inline_executor {
+        template<typename F>
+        auto execute(F&& f) const -> void {
+            std::forward<F>(f)();
+        }
+
+        HASHLIB_NODISCARD auto concurrency() const noexcept -> std::size_t {
+            return 1;
+        }
+    };
+
+    // adapts any callable `post(std::function<void()>)` which hands a task to an existing pool, e.g.
+    // `hashlib::make_executor([&](std::function<void()> task) { pool.enqueue(std::move(task)); }, pool.size())`.
+    HASHLIB_MOD_EXPORT template<typename Post>
+    class function_executor {
+    public:
+        explicit function_executor(Post post, std::size_t concurrency = 0) : post_(std::move(post)), concurrency_(concurrency) {}
+
+        auto execute(std::function<void()> task) const -> void {
+            post_(std::move(task));
+        }
+
+        HASHLIB_NODISCARD auto concurrency() const noexcept -> std::size_t {
+            return concurrency_ != 0 ? concurrency_ : (std::max)(std::thread::hardware_concurrency(), 1u);
+        }
+
+    private:
+        Post post_;
+        std::size_t concurrency_;
+    };
+
+    HASHLIB_MOD_EXPORT template<typename Post>
+    HASHLIB_NODISCARD auto make_executor(Post post, std::size_t concurrency = 0) -> function_executor<Post> {
+        return function_executor<Post>{std::move(post), concurrency};
+    }
+
+    HASHLIB_MOD_EXPORT struct thread_pool_options {
+        // number of workers, 0 means `std::thread::hardware_concurrency()`.
+        std::size_t threads = 0;
+        // pin every worker to one cpu, consecutive workers being spread over the numa nodes.
+        bool pin_threads = false;
+    };
+
+    // the default pool, every worker has its own queue. tasks submitted by a worker go to its own queue and are run
+    // last in first out, idle workers steal the oldest tasks of the others, from the workers of their own numa node
+    // first when they are pinned.
+    // the destructor runs the remaining tasks before joining the workers.
+    HASHLIB_MOD_EXPORT class thread_pool {
+    public:
+        class executor_type {
+        public:
+            explicit executor_type(thread_pool& pool) noexcept : pool_(&pool) {}
+
+            template<typename F>
+            auto execute(F&& f) const -> void {
+                pool_->execute(std::forward<F>(f));
+            }
+
+            HASHLIB_NODISCARD auto concurrency() const noexcept -> std::size_t {
+                return pool_->size();
+            }
+
+        private:
+            thread_pool* pool_;
+        };
+
+    public:
+        // 0 threads means `std::thread::hardware_concurrency()`.
+        explicit thread_pool(std::size_t threads = 0) : thread_pool(make_options_(threads)) {}
+
+        explicit thread_pool(const thread_pool_options& options) {
+            auto threads = options.threads;
+            if (threads == 0) threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+            placements_.resize(threads);
+            if (options.pin_threads) {
+                auto cpus = detail::interleaved_cpus();
+                for (std::size_t i = 0; !cpus.empty() && i < threads; ++i) {
+                    placements_[i].cpu = cpus[i % cpus.size()];
+                    placements_[i].node = detail::numa_node_of_cpu(placements_[i].cpu);
+                }
+            }
+            for (std::size_t i = 0; i < threads; ++i) {
+                queues_.emplace_back(new worker_queue);
+                // the victims of the same node come first, then the others, each in a different order per worker
+                auto& victims = queues_.back()->victims;
+                for (int same_node = 1; same_node >= 0; --same_node) {
+                    for (std::size_t j = 1; j < threads; ++j) {
+                        auto victim = (i + j) % threads;
+                        auto node = placements_[i].node;
+                        if ((node >= 0 && placements_[victim].node == node) == (same_node == 1)) victims.push_back(victim);
+                    }
+                }
+            }
+            try {
+                for (std::size_t i = 0; i < threads; ++i) {
+                    threads_.emplace_back([this, i] { run_(i); });
+                }
+            } catch (...) {
+                stop_();
+                throw;
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+
+        ~thread_pool() {
+            stop_();
+        }
+
+        auto operator= (const thread_pool&) -> thread_pool& = delete;
+
+        HASHLIB_NODISCARD auto size() const noexcept -> std::size_t {
+            return queues_.size();
+        }
+
+        // the cpu and the node of every worker, -1 for the workers which are not pinned.
+        HASHLIB_NODISCARD auto placements() const noexcept -> const std::vector<numa_placement>& {
+            return placements_;
+        }
+
+        HASHLIB_NODISCARD auto get_executor() noexcept -> executor_type {
+            return executor_type{*this};
+        }
+
+        auto execute(std::function<void()> task) -> void {
+            auto& worker = detail::current_pool_worker();
+            auto index = worker.first == this ? worker.second : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+            {
+                std::lock_guard<std::mutex> lock{queues_[index]->mutex};
+                queues_[index]->tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                ++pending_;
+            }
+            cv_.notify_one();
+        }
+
+    private:
+        struct worker_queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+            // the other workers in the order they are stolen from.
+            std::vector<std::size_t> victims;
+        };
+
+        static auto make_options_(std::size_t threads) noexcept -> thread_pool_options {
+            thread_pool_options options;
+            options.threads = threads;
+            return options;
+        }
+
+        auto stop_() noexcept -> void {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stopping_ = true;
+            }
+            cv_.notify_all();
+            for (auto& thread : threads_) thread.join();
+        }
+
+        auto run_(std::size_t index) -> void {
+            detail::current_pool_worker() = {this, index};
+            if (placements_[index].cpu >= 0) detail::pin_current_thread(placements_[index].cpu);
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock{mutex_};
+                    cv_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+                    if (pending_ == 0) return;
+                    // the task counted here is in some queue, and no other worker may take it
+                    --pending_;
+                }
+                std::function<void()> task;
+                while (!take_(index, task)) std::this_thread::yield();
+                task();
+            }
+        }
+
+        auto take_(std::size_t index, std::function<void()>& task) -> bool {
+            {
+                auto& own = *queues_[index];
+                std::lock_guard<std::mutex> lock{own.mutex};
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (auto i : queues_[index]->victims) {
+                auto& victim = *queues_[i];
+                std::lock_guard<std::mutex> lock{victim.mutex};
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::vector<numa_placement> placements_;
+        std::vector<std::unique_ptr<worker_queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::atomic<std::size_t> next_{0};
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::size_t pending_ = 0;
+        bool stopping_ = false;
+    };
+}
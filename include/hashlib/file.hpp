@@ -0,0 +1,446 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include "numa.hpp"
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#if HASHLIB_PLATFORM_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace hashlib {
+    // options of the pipelined file hasher, see `hash_file(path, options)`.
+    HASHLIB_MOD_EXPORT struct file_reader_options {
+        // size of each buffer, it is rounded up to a multiple of the page size.
+        std::size_t buffer_size = std::size_t(1) << 20;
+        // number of buffers, the reader thread fills up to `depth - 1` of them while one is being hashed.
+        std::size_t depth = 2;
+        // open the file with `O_DIRECT` to bypass the page cache, ignored where it is not supported.
+        bool direct_io = false;
+        // back the buffers with huge pages, falls back to transparent huge pages or normal pages.
+        bool huge_pages = false;
+    };
+
+    namespace detail {
+        // files smaller than this are read, mapping them costs more than copying.
+        HASHLIB_CXX17_INLINE constexpr std::size_t file_mmap_threshold = std::size_t(1) << 20;
+        // larger files are mapped window by window, so that the address space and the populated pages stay bounded.
+        HASHLIB_CXX17_INLINE constexpr std::size_t file_mmap_window = std::size_t(64) << 20;
+        HASHLIB_CXX17_INLINE constexpr std::size_t file_read_size = std::size_t(1) << 20;
+
+        inline auto last_error_code() noexcept -> std::error_code {
+            return errno != 0 ? std::error_code{errno, std::generic_category()} : std::make_error_code(std::errc::io_error);
+        }
+
+#if HASHLIB_PLATFORM_POSIX
+        class file_descriptor {
+        public:
+            explicit file_descriptor(int fd) noexcept : fd_(fd) {}
+
+            file_descriptor(const file_descriptor&) = delete;
+
+            ~file_descriptor() {
+                if (fd_ >= 0) ::close(fd_);
+            }
+
+            auto operator= (const file_descriptor&) -> file_descriptor& = delete;
+
+            HASHLIB_NODISCARD auto get() const noexcept -> int {
+                return fd_;
+            }
+
+        private:
+            int fd_;
+        };
+
+        inline auto advise_sequential(int fd) noexcept -> void {
+#ifdef POSIX_FADV_SEQUENTIAL
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+            (void)fd;
+#endif
+        }
+
+        // reads up to `size` bytes from the current offset, returns 0 at the end of the file or on error.
+        inline auto read_some(int fd, byte* data, std::size_t size, std::error_code& ec) noexcept -> std::size_t {
+            for (;;) {
+                auto n = ::read(fd, data, size);
+                if (n >= 0) return static_cast<std::size_t>(n);
+                if (errno == EINTR) continue;
+                ec = last_error_code();
+                return 0;
+            }
+        }
+
+        // hashes the rest of the file from the current offset, this works for pipes, character devices and the like.
+        template<typename Context>
+        auto hash_fd_by_read(Context& ctx, int fd, std::error_code& ec) -> void {
+            advise_sequential(fd);
+            std::unique_ptr<byte[]> buffer{new byte[file_read_size]};
+            for (;;) {
+                auto n = read_some(fd, buffer.get(), file_read_size, ec);
+                if (n == 0) break;
+                ctx.update({buffer.get(), n});
+            }
+        }
+
+        // returns the number of bytes hashed, it stops early if a window cannot be mapped and leaves the rest to the caller.
+        // note: like every user of `mmap`, this gets `SIGBUS` if another process truncates the file concurrently.
+        template<typename Context>
+        auto hash_fd_by_mmap(Context& ctx, int fd, std::uint64_t size) -> std::uint64_t {
+            std::uint64_t offset = 0;
+            while (offset < size) {
+                auto length = static_cast<std::size_t>(std::min<std::uint64_t>(size - offset, file_mmap_window));
+                int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+                flags |= MAP_POPULATE;
+#endif
+                void* addr = ::mmap(nullptr, length, PROT_READ, flags, fd, static_cast<off_t>(offset));
+                if (addr == MAP_FAILED) break;
+#ifdef MADV_SEQUENTIAL
+                ::madvise(addr, length, MADV_SEQUENTIAL);
+#endif
+                ctx.update({static_cast<const byte*>(addr), length});
+                ::munmap(addr, length);
+                offset += length;
+            }
+            return offset;
+        }
+
+        // hashes a file opened at offset 0, `st` is its status.
+        template<typename Context>
+        auto hash_fd_impl(Context& ctx, int fd, const struct stat& st, std::error_code& ec) -> void {
+            // special files (pipes, devices, procfs entries reporting a zero size) can only be read
+            if (S_ISREG(st.st_mode) && static_cast<std::uint64_t>(st.st_size) >= file_mmap_threshold) {
+                auto size = static_cast<std::uint64_t>(st.st_size);
+                auto done = hash_fd_by_mmap(ctx, fd, size);
+                if (done == size) return;
+                if (::lseek(fd, static_cast<off_t>(done), SEEK_SET) < 0) {
+                    ec = last_error_code();
+                    return;
+                }
+            }
+            hash_fd_by_read(ctx, fd, ec);
+        }
+
+        inline auto open_read_only(const std::string& path) noexcept -> int {
+            int flags = O_RDONLY;
+#ifdef O_CLOEXEC
+            flags |= O_CLOEXEC;
+#endif
+            int fd;
+            do {
+                fd = ::open(path.c_str(), flags);
+            } while (fd < 0 && errno == EINTR);
+            return fd;
+        }
+
+        template<typename Context>
+        auto hash_file_impl(Context& ctx, const std::string& path, std::error_code& ec) -> void {
+            int fd = open_read_only(path);
+            if (fd < 0) {
+                ec = last_error_code();
+                return;
+            }
+            file_descriptor guard{fd};
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0) {
+                ec = last_error_code();
+                return;
+            }
+            hash_fd_impl(ctx, fd, st, ec);
+        }
+#else
+        inline auto open_read_only(const std::string& path, std::ifstream& file, std::error_code& ec) -> void {
+            errno = 0;
+            file.open(path, std::ios::in | std::ios::binary);
+            if (!file) ec = last_error_code();
+        }
+
+        // reads up to `size` bytes, returns 0 at the end of the file or on error.
+        inline auto read_some(std::ifstream& file, byte* data, std::size_t size, std::error_code& ec) -> std::size_t {
+            file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+            if (file.bad()) {
+                ec = std::make_error_code(std::errc::io_error);
+                return 0;
+            }
+            return static_cast<std::size_t>(file.gcount());
+        }
+
+        template<typename Context>
+        auto hash_file_impl(Context& ctx, const std::string& path, std::error_code& ec) -> void {
+            std::ifstream file;
+            open_read_only(path, file, ec);
+            if (ec) return;
+            ctx.update(file);
+            if (file.bad()) {
+                ec = std::make_error_code(std::errc::io_error);
+            }
+        }
+#endif
+    }
+
+    namespace detail {
+        HASHLIB_CXX17_INLINE constexpr std::size_t io_alignment = 4096;
+        HASHLIB_CXX17_INLINE constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+        inline auto round_up(std::size_t n, std::size_t alignment) noexcept -> std::size_t {
+            return (n + alignment - 1) / alignment * alignment;
+        }
+
+        // page-aligned memory suitable for `O_DIRECT`, its pages are taken from `node` when it is not -1.
+        class aligned_buffer {
+        public:
+            aligned_buffer(std::size_t size, bool huge_pages, int node = -1) : size_(round_up(size, io_alignment)) {
+#if HASHLIB_PLATFORM_POSIX
+                void* addr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+                if (huge_pages) {
+                    size_ = round_up(size_, huge_page_size);
+                    addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                }
+#endif
+                if (addr == MAP_FAILED) {
+                    addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (addr == MAP_FAILED) throw std::bad_alloc{};
+#ifdef MADV_HUGEPAGE
+                    if (huge_pages) ::madvise(addr, size_, MADV_HUGEPAGE);
+#endif
+                }
+                // nothing has touched the pages yet
+                if (node >= 0) prefer_numa_node(addr, size_, node);
+                data_ = static_cast<byte*>(addr);
+#else
+                (void)huge_pages;
+                (void)node;
+                data_ = new byte[size_];
+#endif
+            }
+
+            aligned_buffer(aligned_buffer&& other) noexcept : data_(other.data_), size_(other.size_) {
+                other.data_ = nullptr;
+            }
+
+            aligned_buffer(const aligned_buffer&) = delete;
+
+            ~aligned_buffer() {
+                if (!data_) return;
+#if HASHLIB_PLATFORM_POSIX
+                ::munmap(data_, size_);
+#else
+                delete[] data_;
+#endif
+            }
+
+            auto operator= (const aligned_buffer&) -> aligned_buffer& = delete;
+
+            HASHLIB_NODISCARD auto data() const noexcept -> byte* {
+                return data_;
+            }
+
+            HASHLIB_NODISCARD auto size() const noexcept -> std::size_t {
+                return size_;
+            }
+
+        private:
+            byte* data_ = nullptr;
+            std::size_t size_;
+        };
+
+#if HASHLIB_PLATFORM_POSIX
+        class pipeline_source {
+        public:
+            pipeline_source(const std::string& path, bool direct_io, std::error_code& ec) : fd_(open_(path, direct_io, ec)) {
+#ifdef POSIX_FADV_SEQUENTIAL
+                if (fd_.get() >= 0) ::posix_fadvise(fd_.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            }
+
+            // fills `buffer` as much as possible, a short count means the end of the file was reached.
+            auto read(byte* buffer, std::size_t size, std::error_code& ec) -> std::size_t {
+                std::size_t filled = 0;
+                while (filled < size) {
+                    auto n = ::read(fd_.get(), buffer + filled, size - filled);
+                    if (n < 0) {
+                        int error = errno;
+                        if (error == EINTR) continue;
+#ifdef O_DIRECT
+                        // a short read leaves the next transfer unaligned, finish the file without `O_DIRECT`
+                        int flags = ::fcntl(fd_.get(), F_GETFL);
+                        if (error == EINVAL && flags >= 0 && (flags & O_DIRECT) && ::fcntl(fd_.get(), F_SETFL, flags & ~O_DIRECT) == 0) {
+                            continue;
+                        }
+#endif
+                        ec = std::error_code{error, std::generic_category()};
+                        break;
+                    }
+                    if (n == 0) break;
+                    filled += static_cast<std::size_t>(n);
+                }
+                return filled;
+            }
+
+        private:
+            static auto open_(const std::string& path, bool direct_io, std::error_code& ec) -> int {
+                int flags = O_RDONLY;
+#ifdef O_CLOEXEC
+                flags |= O_CLOEXEC;
+#endif
+                int fd = -1;
+#ifdef O_DIRECT
+                if (direct_io) {
+                    // some file systems (e.g. tmpfs) reject `O_DIRECT`, they are read through the page cache instead
+                    do {
+                        fd = ::open(path.c_str(), flags | O_DIRECT);
+                    } while (fd < 0 && errno == EINTR);
+                }
+#else
+                (void)direct_io;
+#endif
+                while (fd < 0) {
+                    fd = ::open(path.c_str(), flags);
+                    if (fd < 0 && errno != EINTR) {
+                        ec = last_error_code();
+                        break;
+                    }
+                }
+                return fd;
+            }
+
+        private:
+            file_descriptor fd_;
+        };
+#else
+        class pipeline_source {
+        public:
+            pipeline_source(const std::string& path, bool, std::error_code& ec) {
+                errno = 0;
+                file_.open(path, std::ios::in | std::ios::binary);
+                if (!file_) ec = last_error_code();
+            }
+
+            auto read(byte* buffer, std::size_t size, std::error_code& ec) -> std::size_t {
+                file_.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+                if (file_.bad()) ec = std::make_error_code(std::errc::io_error);
+                return static_cast<std::size_t>(file_.gcount());
+            }
+
+        private:
+            std::ifstream file_;
+        };
+#endif
+
+        // a reader thread fills the buffers in file order while the calling thread hashes the ones already filled.
+        template<typename Context>
+        auto hash_file_pipelined(Context& ctx, const std::string& path, const file_reader_options& options, std::error_code& ec) -> void {
+            pipeline_source source{path, options.direct_io, ec};
+            if (ec) return;
+
+            std::vector<aligned_buffer> buffers;
+            std::size_t depth = (std::max)(options.depth, std::size_t(1));
+            buffers.reserve(depth);
+            // the reader thread touches the buffers first, but the calling thread hashes them
+            auto node = current_numa_placement().node;
+            for (std::size_t i = 0; i < depth; ++i) {
+                buffers.emplace_back((std::max)(options.buffer_size, io_alignment), options.huge_pages, node);
+            }
+
+            struct filled_buffer {
+                std::size_t index;
+                std::size_t size;
+            };
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::deque<std::size_t> free_buffers;
+            std::deque<filled_buffer> filled_buffers;
+            bool finished = false;
+            std::error_code read_ec;
+            for (std::size_t i = 0; i < depth; ++i) free_buffers.push_back(i);
+
+            std::thread reader{[&] {
+                for (;;) {
+                    std::size_t index;
+                    {
+                        std::unique_lock<std::mutex> lock{mutex};
+                        cv.wait(lock, [&] { return !free_buffers.empty(); });
+                        index = free_buffers.front();
+                        free_buffers.pop_front();
+                    }
+                    std::error_code local_ec;
+                    auto& buffer = buffers[index];
+                    auto n = source.read(buffer.data(), buffer.size(), local_ec);
+                    std::lock_guard<std::mutex> lock{mutex};
+                    if (n > 0) filled_buffers.push_back({index, n});
+                    if (local_ec || n < buffer.size()) {
+                        read_ec = local_ec;
+                        finished = true;
+                    }
+                    cv.notify_all();
+                    if (finished) return;
+                }
+            }};
+
+            for (;;) {
+                filled_buffer filled;
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    cv.wait(lock, [&] { return !filled_buffers.empty() || finished; });
+                    if (filled_buffers.empty()) break;
+                    filled = filled_buffers.front();
+                    filled_buffers.pop_front();
+                }
+                ctx.update({buffers[filled.index].data(), filled.size});
+                std::lock_guard<std::mutex> lock{mutex};
+                free_buffers.push_back(filled.index);
+                cv.notify_all();
+            }
+            reader.join();
+            ec = read_ec;
+        }
+    }
+
+    // hashes the whole file at `path`, large regular files are memory-mapped, everything else is read in large chunks.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    HASHLIB_NODISCARD auto hash_file(const std::string& path, std::error_code& ec) -> Algo {
+        Algo ctx;
+        ec.clear();
+        detail::hash_file_impl(ctx, path, ec);
+        return ctx;
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    HASHLIB_NODISCARD auto hash_file(const std::string& path) -> Algo {
+        std::error_code ec;
+        auto ctx = hash_file<Algo>(path, ec);
+        if (ec) throw std::system_error{ec, "hashlib::hash_file: " + path};
+        return ctx;
+    }
+
+    // hashes the whole file at `path` with a reader thread which keeps the next buffers filled while the current one
+    // is hashed, this keeps both the device and the core busy when the file is not cached.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    HASHLIB_NODISCARD auto hash_file(const std::string& path, const file_reader_options& options, std::error_code& ec) -> Algo {
+        Algo ctx;
+        ec.clear();
+        detail::hash_file_pipelined(ctx, path, options, ec);
+        return ctx;
+    }
+
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    HASHLIB_NODISCARD auto hash_file(const std::string& path, const file_reader_options& options) -> Algo {
+        std::error_code ec;
+        auto ctx = hash_file<Algo>(path, options, ec);
+        if (ec) throw std::system_error{ec, "hashlib::hash_file: " + path};
+        return ctx;
+    }
+}
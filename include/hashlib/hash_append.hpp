@@ -0,0 +1,333 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include <tuple>
+#endif
+
+namespace hashlib {
+    // an integer appended with an explicit byte order, see `big_endian` and `little_endian`.
+    HASHLIB_MOD_EXPORT template<typename T>
+    struct big_endian_value {
+        T value;
+    };
+
+    HASHLIB_MOD_EXPORT template<typename T>
+    struct little_endian_value {
+        T value;
+    };
+
+    // e.g. `hashlib::hash_append(ctx, hashlib::big_endian(length))` to match a big endian wire format.
+    HASHLIB_MOD_EXPORT template<typename T, detail::enable_if_t<std::is_integral<T>::value>* = nullptr>
+    HASHLIB_NODISCARD constexpr auto big_endian(T value) noexcept -> big_endian_value<T> {
+        return {value};
+    }
+
+    HASHLIB_MOD_EXPORT template<typename T, detail::enable_if_t<std::is_integral<T>::value>* = nullptr>
+    HASHLIB_NODISCARD constexpr auto little_endian(T value) noexcept -> little_endian_value<T> {
+        return {value};
+    }
+
+    namespace detail {
+        template<typename Context, typename = void>
+        struct has_put : std::false_type {};
+
+        template<typename Context>
+        struct has_put<Context, void_t<decltype(std::declval<Context&>().put(std::declval<span<const byte>>()))>> :
+            std::true_type {};
+    }
+
+    // hands the bytes of the appended values to `Context::put`, which copies them into the partial block, so that small
+    // fields do not pay for a whole `update` each. a context without `put`, e.g. `af_alg_context`, gets an `update`.
+    // it is the hash algorithm of the `hash_append` overloads, in the sense of N3980.
+    HASHLIB_MOD_EXPORT template<typename Context>
+    class hash_appender {
+    public:
+        explicit hash_appender(Context& ctx) noexcept : ctx_(ctx) {}
+
+        hash_appender(const hash_appender&) = delete;
+
+        auto operator= (const hash_appender&) -> hash_appender& = delete;
+
+        auto operator()(const void* data, std::size_t size) -> void {
+            append_({static_cast<const byte*>(data), size}, detail::has_put<Context>{});
+        }
+
+    private:
+        auto append_(span<const byte> bytes, std::true_type) -> void {
+            ctx_.put(bytes);
+        }
+
+        auto append_(span<const byte> bytes, std::false_type) -> void {
+            ctx_.update(bytes);
+        }
+
+        Context& ctx_;
+    };
+
+    namespace detail {
+        template<typename T>
+        struct is_hash_appender : std::false_type {};
+
+        template<typename Context>
+        struct is_hash_appender<hash_appender<Context>> : std::true_type {};
+
+        template<typename T>
+        using make_unsigned_t = typename std::make_unsigned<T>::type;
+
+        template<typename H, typename T>
+        auto append_le(H& h, T value) -> void {
+            byte bytes[sizeof(T)];
+            auto u = static_cast<make_unsigned_t<T>>(value);
+            for (std::size_t i = 0; i < sizeof(T); ++i) bytes[i] = static_cast<byte>(u >> (8 * i));
+            h(bytes, sizeof(T));
+        }
+
+        template<typename H, typename T>
+        auto append_be(H& h, T value) -> void {
+            byte bytes[sizeof(T)];
+            auto u = static_cast<make_unsigned_t<T>>(value);
+            for (std::size_t i = 0; i < sizeof(T); ++i) bytes[sizeof(T) - 1 - i] = static_cast<byte>(u >> (8 * i));
+            h(bytes, sizeof(T));
+        }
+
+        // the integers are appended little endian, so an array of them is already in that layout on such platforms.
+        template<typename T>
+        using is_contiguously_appendable = bool_constant<
+            is_byte_like<T>::value ||
+            (std::is_integral<T>::value && !std::is_same<T, bool>::value && is_little_endian())
+        >;
+
+        template<typename T, typename = void>
+        struct is_tuple_like : std::false_type {};
+
+        template<typename T>
+        struct is_tuple_like<T, void_t<decltype(std::tuple_size<T>::value)>> : bool_constant<!is_input_range<T>::value> {};
+
+#if HASHLIB_CXX_STANDARD >= HASHLIB_CXX_STD17
+        struct any_field {
+            template<typename T>
+            operator T() const;
+        };
+
+        template<typename T, typename... Fields>
+        auto is_brace_constructible(int) -> decltype(T{{std::declval<Fields>()}...}, std::true_type{});
+
+        template<typename T, typename... Fields>
+        auto is_brace_constructible(...) -> std::false_type;
+
+        HASHLIB_CXX17_INLINE constexpr std::size_t max_aggregate_fields = 8;
+
+        // the number of fields, counted as the number of braced values the aggregate can be initialized from. each value
+        // is braced so that an array field takes one of them, rather than one per element by brace elision.
+        template<typename T, typename... Fields>
+        constexpr auto aggregate_field_count() -> std::size_t {
+            if constexpr (sizeof...(Fields) <= max_aggregate_fields && decltype(is_brace_constructible<T, Fields..., any_field>(0))::value) {
+                return aggregate_field_count<T, Fields..., any_field>();
+            }
+            else {
+                return sizeof...(Fields);
+            }
+        }
+
+        template<std::size_t>
+        using indexed_field = any_field;
+
+        template<typename T, std::size_t... I>
+        auto has_uncounted_field(index_sequence<I...>, int) -> decltype(T{{std::declval<indexed_field<I>>()}..., {}}, std::true_type{});
+
+        template<typename T, std::size_t... I>
+        auto has_uncounted_field(index_sequence<I...>, ...) -> std::false_type;
+
+        // the count stops early at a field which cannot be initialized from a value, e.g. an empty struct.
+        template<typename T>
+        constexpr auto has_uncounted_field() -> bool {
+            return decltype(has_uncounted_field<T>(make_index_sequence<aggregate_field_count<T>()>{}, 0))::value;
+        }
+
+        template<typename T, typename = void>
+        struct is_appendable_aggregate : std::false_type {};
+
+        template<typename T>
+        struct is_appendable_aggregate<T, enable_if_t<
+            std::is_aggregate<T>::value && !std::is_array<T>::value &&
+            !is_input_range<T>::value && !is_tuple_like<T>::value &&
+            aggregate_field_count<T>() <= max_aggregate_fields
+        >> : std::true_type {};
+#endif
+    }
+
+    // the overloads below append the values of the common types, an overload for a user type goes in the namespace of
+    // that type, e.g. `template<typename H> void hash_append(H& h, const point& p) { hashlib::hash_append(h, p.x, p.y); }`.
+    // integers are appended little endian, ranges are followed by their size as 64 bits, so that `{"ab", "c"}` and
+    // `{"a", "bc"}` have different digests.
+
+    HASHLIB_MOD_EXPORT template<typename H, typename T, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && std::is_integral<T>::value && !std::is_same<T, bool>::value
+    >* = nullptr>
+    auto hash_append(H& h, T value) -> void {
+        detail::append_le(h, value);
+    }
+
+    HASHLIB_MOD_EXPORT template<typename H, detail::enable_if_t<detail::is_hash_appender<H>::value>* = nullptr>
+    auto hash_append(H& h, bool value) -> void {
+        detail::append_le(h, static_cast<std::uint8_t>(value ? 1 : 0));
+    }
+
+    HASHLIB_MOD_EXPORT template<typename H, typename T, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && std::is_enum<T>::value
+    >* = nullptr>
+    auto hash_append(H& h, T value) -> void {
+        detail::append_le(h, static_cast<typename std::underlying_type<T>::type>(value));
+    }
+
+    HASHLIB_MOD_EXPORT template<typename H, typename T, detail::enable_if_t<detail::is_hash_appender<H>::value>* = nullptr>
+    auto hash_append(H& h, big_endian_value<T> value) -> void {
+        detail::append_be(h, value.value);
+    }
+
+    HASHLIB_MOD_EXPORT template<typename H, typename T, detail::enable_if_t<detail::is_hash_appender<H>::value>* = nullptr>
+    auto hash_append(H& h, little_endian_value<T> value) -> void {
+        detail::append_le(h, value.value);
+    }
+
+    HASHLIB_MOD_EXPORT template<typename H, typename T, typename... Ts, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && (sizeof...(Ts) > 0)
+    >* = nullptr>
+    auto hash_append(H& h, const T& value, const Ts&... values) -> void;
+
+    namespace detail {
+        template<typename H, typename T, enable_if_t<is_contiguously_appendable<T>::value>* = nullptr>
+        auto append_elements(H& h, const T* data, std::size_t size) -> void {
+            if (size > 0) h(data, size * sizeof(T));
+        }
+
+        template<typename H, typename T, enable_if_t<!is_contiguously_appendable<T>::value>* = nullptr>
+        auto append_elements(H& h, const T* data, std::size_t size) -> void {
+            for (std::size_t i = 0; i < size; ++i) hash_append(h, data[i]);
+        }
+
+        template<typename H, typename Tuple>
+        auto append_tuple(H&, const Tuple&, index_sequence<>) -> void {}
+
+        template<typename H, typename Tuple, std::size_t... I>
+        auto append_tuple(H& h, const Tuple& value, index_sequence<I...>) -> void {
+            using std::get;
+            hash_append(h, get<I>(value)...);
+        }
+
+#if HASHLIB_CXX_STANDARD >= HASHLIB_CXX_STD17
+        template<typename H, typename T>
+        auto append_fields(H&, const T&, std::integral_constant<std::size_t, 0>) -> void {}
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 1>) -> void {
+            const auto& [a] = value;
+            hash_append(h, a);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 2>) -> void {
+            const auto& [a, b] = value;
+            hash_append(h, a, b);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 3>) -> void {
+            const auto& [a, b, c] = value;
+            hash_append(h, a, b, c);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 4>) -> void {
+            const auto& [a, b, c, d] = value;
+            hash_append(h, a, b, c, d);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 5>) -> void {
+            const auto& [a, b, c, d, e] = value;
+            hash_append(h, a, b, c, d, e);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 6>) -> void {
+            const auto& [a, b, c, d, e, f] = value;
+            hash_append(h, a, b, c, d, e, f);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 7>) -> void {
+            const auto& [a, b, c, d, e, f, g] = value;
+            hash_append(h, a, b, c, d, e, f, g);
+        }
+
+        template<typename H, typename T>
+        auto append_fields(H& h, const T& value, std::integral_constant<std::size_t, 8>) -> void {
+            const auto& [a, b, c, d, e, f, g, i] = value;
+            hash_append(h, a, b, c, d, e, f, g, i);
+        }
+#endif
+    }
+
+    // the elements of a contiguous range of bytes, or of integers on a little endian platform, are appended at once.
+    HASHLIB_MOD_EXPORT template<typename H, typename Range, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && detail::is_contiguous_range<const Range>::value
+    >* = nullptr>
+    auto hash_append(H& h, const Range& range) -> void {
+        auto size = static_cast<std::size_t>(std::end(range) - std::begin(range));
+        detail::append_elements(h, detail::data(range), size);
+        detail::append_le(h, static_cast<std::uint64_t>(size));
+    }
+
+    HASHLIB_MOD_EXPORT template<typename H, typename Range, detail::enable_if_t<
+        detail::is_hash_appender<H>::value &&
+        detail::is_input_range<const Range>::value && !detail::is_contiguous_range<const Range>::value
+    >* = nullptr>
+    auto hash_append(H& h, const Range& range) -> void {
+        std::uint64_t size = 0;
+        for (const auto& element : range) {
+            hash_append(h, element);
+            ++size;
+        }
+        detail::append_le(h, size);
+    }
+
+    // std::pair, std::tuple and the other types with std::tuple_size and get, one element after another.
+    HASHLIB_MOD_EXPORT template<typename H, typename Tuple, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && detail::is_tuple_like<Tuple>::value
+    >* = nullptr>
+    auto hash_append(H& h, const Tuple& value) -> void {
+        detail::append_tuple(h, value, detail::make_index_sequence<std::tuple_size<Tuple>::value>{});
+    }
+
+#if HASHLIB_CXX_STANDARD >= HASHLIB_CXX_STD17
+    // the fields of an aggregate without base classes, one after another. an array field is appended as a range.
+    HASHLIB_MOD_EXPORT template<typename H, typename T, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && detail::is_appendable_aggregate<T>::value
+    >* = nullptr>
+    auto hash_append(H& h, const T& value) -> void {
+        static_assert(!detail::has_uncounted_field<T>(),
+            "hashlib::hash_append: every field of the aggregate shall be initializable from a single value, "
+            "provide a hash_append overload for this type");
+        detail::append_fields(h, value, std::integral_constant<std::size_t, detail::aggregate_field_count<T>()>{});
+    }
+#endif
+
+    HASHLIB_MOD_EXPORT template<typename H, typename T, typename... Ts, detail::enable_if_t<
+        detail::is_hash_appender<H>::value && (sizeof...(Ts) > 0)
+    >*>
+    auto hash_append(H& h, const T& value, const Ts&... values) -> void {
+        hash_append(h, value);
+        hash_append(h, values...);
+    }
+
+    // appends `values` to `ctx`, e.g. `hashlib::hash_append(ctx, header.id, header.flags, header.name)`.
+    HASHLIB_MOD_EXPORT template<typename Context, typename... Ts, detail::enable_if_t<
+        !detail::is_hash_appender<Context>::value
+    >* = nullptr>
+    auto hash_append(Context& ctx, const Ts&... values) -> void {
+        hash_appender<Context> h{ctx};
+        int expand[] = {0, (hash_append(h, values), 0)...};
+        (void)expand;
+    }
+}
@@ -0,0 +1,196 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include "each.hpp"
+#include "md5.hpp"
+#include "sha1.hpp"
+#include "sha2.hpp"
+#include "sha3.hpp"
+#endif
+
+namespace hashlib {
+    namespace detail {
+        // the operations of `hasher`, every call takes whole spans or batches of them, so that the indirect call is
+        // paid once per batch rather than once per field.
+        class hasher_impl {
+        public:
+            virtual ~hasher_impl() = default;
+
+            virtual auto clone() const -> std::unique_ptr<hasher_impl> = 0;
+
+            virtual auto update(span<const byte> bytes) noexcept -> void = 0;
+
+            virtual auto update(span<const span<const byte>> chunks) noexcept -> void = 0;
+
+            virtual auto digest(byte* out) noexcept -> void = 0;
+
+            virtual auto digest_each(span<const span<const byte>> messages, byte* out) const -> void = 0;
+
+            virtual auto clear() noexcept -> void = 0;
+        };
+
+        template<typename Algo>
+        class typed_hasher_impl final : public hasher_impl {
+        public:
+            auto clone() const -> std::unique_ptr<hasher_impl> override {
+                return std::unique_ptr<hasher_impl>{new typed_hasher_impl{*this}};
+            }
+
+            auto update(span<const byte> bytes) noexcept -> void override {
+                ctx_.update(bytes);
+            }
+
+            auto update(span<const span<const byte>> chunks) noexcept -> void override {
+                for (auto chunk : chunks) ctx_.update(chunk);
+            }
+
+            auto digest(byte* out) noexcept -> void override {
+                auto result = ctx_.digest();
+                std::copy(result.begin(), result.end(), out);
+            }
+
+            auto digest_each(span<const span<const byte>> messages, byte* out) const -> void override {
+                std::vector<std::array<byte, Algo::digest_size>> digests(messages.size());
+                hash_each<Algo>(execution::unseq, messages.begin(), messages.end(), digests.begin());
+                for (const auto& d : digests) out = std::copy(d.begin(), d.end(), out);
+            }
+
+            auto clear() noexcept -> void override {
+                ctx_.clear();
+            }
+
+        private:
+            Algo ctx_;
+        };
+
+        struct hasher_algorithm {
+            const char* name;
+            std::size_t digest_size;
+            std::size_t block_size;
+            auto (*make)() -> std::unique_ptr<hasher_impl>;
+        };
+
+        template<typename Algo>
+        auto make_hasher_impl() -> std::unique_ptr<hasher_impl> {
+            return std::unique_ptr<hasher_impl>{new typed_hasher_impl<Algo>};
+        }
+
+        template<typename Algo>
+        constexpr auto hasher_algorithm_of(const char* name) noexcept -> hasher_algorithm {
+            return {name, Algo::digest_size, Algo::block_size, &make_hasher_impl<Algo>};
+        }
+
+        // the names are those of python's `hashlib.new`.
+        inline auto hasher_algorithms() noexcept -> span<const hasher_algorithm> {
+            static const hasher_algorithm algorithms[] = {
+                hasher_algorithm_of<context<md5>>("md5"),
+                hasher_algorithm_of<context<sha1>>("sha1"),
+                hasher_algorithm_of<context<sha224>>("sha224"),
+                hasher_algorithm_of<context<sha256>>("sha256"),
+                hasher_algorithm_of<context<sha384>>("sha384"),
+                hasher_algorithm_of<context<sha512>>("sha512"),
+                hasher_algorithm_of<context<sha3<224>>>("sha3_224"),
+                hasher_algorithm_of<context<sha3<256>>>("sha3_256"),
+                hasher_algorithm_of<context<sha3<384>>>("sha3_384"),
+                hasher_algorithm_of<context<sha3<512>>>("sha3_512")
+            };
+            return {algorithms, sizeof(algorithms) / sizeof(algorithms[0])};
+        }
+    }
+
+    // a context of an algorithm chosen at run time by its name, e.g. `hashlib::hasher::create("sha256")` from a
+    // configuration file. every operation is an indirect call, so it takes a whole span, and `update` and
+    // `digest_each` also take batches of spans to pay for the call once per batch.
+    HASHLIB_MOD_EXPORT class hasher {
+    public:
+        // throws `std::invalid_argument` if there is no algorithm named `name`, see `algorithms()`.
+        HASHLIB_NODISCARD static auto create(const std::string& name) -> hasher {
+            for (const auto& algorithm : detail::hasher_algorithms()) {
+                if (name == algorithm.name) return hasher{algorithm};
+            }
+            throw std::invalid_argument{"hashlib: unknown algorithm " + name};
+        }
+
+        // the names accepted by `create`.
+        HASHLIB_NODISCARD static auto algorithms() -> std::vector<std::string> {
+            std::vector<std::string> result;
+            for (const auto& algorithm : detail::hasher_algorithms()) result.emplace_back(algorithm.name);
+            return result;
+        }
+
+        hasher(const hasher& other) : algorithm_(other.algorithm_), impl_(other.impl_->clone()) {}
+
+        hasher(hasher&&) noexcept = default;
+
+        auto operator= (const hasher& other) -> hasher& {
+            if (this != &other) {
+                impl_ = other.impl_->clone();
+                algorithm_ = other.algorithm_;
+            }
+            return *this;
+        }
+
+        auto operator= (hasher&&) noexcept -> hasher& = default;
+
+        HASHLIB_NODISCARD auto name() const noexcept -> const char* {
+            return algorithm_->name;
+        }
+
+        HASHLIB_NODISCARD auto digest_size() const noexcept -> std::size_t {
+            return algorithm_->digest_size;
+        }
+
+        HASHLIB_NODISCARD auto block_size() const noexcept -> std::size_t {
+            return algorithm_->block_size;
+        }
+
+        auto update(span<const byte> bytes) noexcept -> void {
+            impl_->update(bytes);
+        }
+
+        // the chunks one after another, e.g. the scattered fields of a message.
+        auto update(span<const span<const byte>> chunks) noexcept -> void {
+            impl_->update(chunks);
+        }
+
+        template<typename Range, detail::enable_if_t<detail::is_message<Range>::value>* = nullptr>
+        auto update(const Range& rng) noexcept -> void {
+            impl_->update(detail::message_bytes(rng));
+        }
+
+        HASHLIB_NODISCARD auto digest() -> std::vector<byte> {
+            std::vector<byte> result(digest_size());
+            impl_->digest(result.data());
+            return result;
+        }
+
+        // writes the `digest_size()` bytes of the digest to `out`.
+        auto digest(span<byte> out) -> void {
+            if (out.size() < digest_size()) throw std::invalid_argument{"hashlib: the digest does not fit"};
+            impl_->digest(out.data());
+        }
+
+        HASHLIB_NODISCARD auto hexdigest() -> std::string {
+            auto result = digest();
+            return detail::to_hex({result.data(), result.size()});
+        }
+
+        // the digests of separate messages, unrelated to the state of this hasher, one after another in `out`. the
+        // messages are hashed several at a time where the algorithm has a multi-buffer kernel, see `hash_each`.
+        auto digest_each(span<const span<const byte>> messages, span<byte> out) const -> void {
+            if (out.size() < messages.size() * digest_size()) throw std::invalid_argument{"hashlib: the digests do not fit"};
+            impl_->digest_each(messages, out.data());
+        }
+
+        auto clear() noexcept -> void {
+            impl_->clear();
+        }
+
+    private:
+        explicit hasher(const detail::hasher_algorithm& algorithm) : algorithm_(&algorithm), impl_(algorithm.make()) {}
+
+    private:
+        const detail::hasher_algorithm* algorithm_;
+        std::unique_ptr<detail::hasher_impl> impl_;
+    };
+}
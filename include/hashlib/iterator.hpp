@@ -0,0 +1,83 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#endif
+
+namespace hashlib {
+    // an output iterator which hashes the bytes assigned through it, e.g. the output of `std::transform` or of an
+    // encoder. the bytes are collected in a few blocks inside the iterator and handed to `update` when these fill, so
+    // there is neither an intermediate container nor a call per byte. the rest is handed over when the iterator is
+    // copied or destroyed, so the context is complete once the algorithm writing to it has returned, e.g. at the end
+    // of `std::copy(first, last, hashlib::hash_output(ctx));`. each copy collects its own bytes, which reach the context
+    // when that copy is flushed, so bytes written alternately through several live copies are not hashed in the order
+    // they were written. an algorithm passes the iterator by value and writes through one copy at a time, which is fine.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    class hash_output_iterator {
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+        using context_type = Algo;
+
+    public:
+        explicit hash_output_iterator(Algo& ctx) noexcept : ctx_(std::addressof(ctx)) {}
+
+        // only the context is copied, the bytes collected by `other` are handed over first.
+        hash_output_iterator(const hash_output_iterator& other) noexcept : ctx_(other.ctx_) {
+            other.flush();
+        }
+
+        ~hash_output_iterator() {
+            flush();
+        }
+
+        auto operator= (const hash_output_iterator& other) noexcept -> hash_output_iterator& {
+            flush();
+            other.flush();
+            ctx_ = other.ctx_;
+            return *this;
+        }
+
+        template<typename T, detail::enable_if_t<detail::is_byte_like<T>::value>* = nullptr>
+        HASHLIB_ALWAYS_INLINE auto operator= (T value) noexcept -> hash_output_iterator& {
+            buffer_[size_++] = static_cast<byte>(value);
+            if (size_ == sizeof(buffer_)) flush();
+            return *this;
+        }
+
+        auto operator* () noexcept -> hash_output_iterator& {
+            return *this;
+        }
+
+        auto operator++ () noexcept -> hash_output_iterator& {
+            return *this;
+        }
+
+        auto operator++ (int) noexcept -> hash_output_iterator& {
+            return *this;
+        }
+
+        // hands the collected bytes to the context.
+        auto flush() const noexcept -> void {
+            if (size_ == 0) return;
+            ctx_->update({buffer_, size_});
+            size_ = 0;
+        }
+
+    private:
+        // at least a few hundred bytes, `multi` has no block size.
+        static constexpr std::size_t buffer_size_ = 4 * Algo::block_size > 256 ? 4 * Algo::block_size : 256;
+
+        Algo* ctx_;
+        mutable std::size_t size_ = 0;
+        mutable byte buffer_[buffer_size_];
+    };
+
+    // e.g. `std::copy(first, last, hashlib::hash_output(ctx))`.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    HASHLIB_NODISCARD auto hash_output(Algo& ctx) noexcept -> hash_output_iterator<Algo> {
+        return hash_output_iterator<Algo>{ctx};
+    }
+}
@@ -8,42 +8,18 @@ namespace hashlib {
         class md5 {
         public:
             static constexpr std::size_t digest_size = 16;
+            static constexpr std::size_t block_size = 64;
+            using state_type = std::array<std::uint32_t, 4>;
 
         public:
             auto update(span<const byte> bytes) noexcept -> void {
-                update(bytes.begin(), bytes.end());
-            }
-
-            template<typename InputIt, typename Sentinel, enable_if_t<
-                is_input_iterator<InputIt>::value &&
-                !is_random_access_iterator<InputIt>::value &&
-                is_sentinel_for<Sentinel, InputIt>::value &&
-                is_byte_like<iter_value_t<InputIt>>::value
-            >* = nullptr>
-            auto update(InputIt first, Sentinel last) -> void {
-                byte temp[128];
-                for (auto it = first; it != last;) {
-                    std::size_t n = 0;
-                    for (; it != last && n < sizeof(temp); ++it, ++n) {
-                        temp[n] = static_cast<byte>(*it);
-                    }
-                    update({temp, n});
-                }
-            }
-
-            template<typename RandomAccessIt, typename Sentinel, enable_if_t<
-                is_random_access_iterator<RandomAccessIt>::value &&
-                is_sentinel_for<Sentinel, RandomAccessIt>::value &&
-                is_byte_like<iter_value_t<RandomAccessIt>>::value
-            >* = nullptr>
-            auto update(RandomAccessIt first, Sentinel last) -> void {
-                std::size_t bytes_count = last - first;
+                std::size_t bytes_count = bytes.size();
                 total_size_ += bytes_count;
                 std::size_t i = 0;
 
                 if (buffer_size_ > 0) {
                     std::size_t to_copy = std::min(bytes_count, 64 - buffer_size_);
-                    std::copy_n(first, to_copy, buffer_.data() + buffer_size_);
+                    std::copy_n(bytes.data(), to_copy, buffer_.data() + buffer_size_);
                     buffer_size_ += to_copy;
                     i += to_copy;
                     if (buffer_size_ == 64) {
@@ -53,11 +29,11 @@ namespace hashlib {
                 }
 
                 for (; i + 63 < bytes_count; i += 64) {
-                    (process_)((w_table_)(std::next(first, i)));
+                    process_(w_table_(bytes.data() + i));
                 }
 
                 if (i < bytes_count) {
-                    std::copy_n(std::next(first, i), bytes_count - i, buffer_.data());
+                    std::copy_n(bytes.data() + i, bytes_count - i, buffer_.data());
                     buffer_size_ = bytes_count - i;
                 }
             }
@@ -77,6 +53,45 @@ namespace hashlib {
                 return {a_, b_, c_, d_};
             }
 
+            template<std::size_t N>
+            auto do_hash_fixed(const byte* data) noexcept -> std::array<std::uint32_t, 4> {
+                using padding = fixed_padding<N, 64, 8, false>;
+                for (std::size_t i = 0; i < padding::full_blocks; ++i) {
+                    process_(w_table_(data + i * 64));
+                }
+                if (padding::has_tail_block) {
+                    process_(w_table_(padding::tail_block(data + padding::full_blocks * 64).data()));
+                }
+                if (padding::has_constant_block) {
+                    static const auto w = w_table_(padding::constant_block().data());
+                    process_(w);
+                }
+                return {a_, b_, c_, d_};
+            }
+
+            auto do_midstate() const noexcept -> basic_midstate<state_type> {
+                return {state_type{{a_, b_, c_, d_}}, total_size_ - buffer_size_};
+            }
+
+            auto do_load_midstate(const basic_midstate<state_type>& midstate) noexcept -> bool {
+                if (midstate.size % block_size != 0) return false;
+                a_ = midstate.state[0];
+                b_ = midstate.state[1];
+                c_ = midstate.state[2];
+                d_ = midstate.state[3];
+                total_size_ = midstate.size;
+                buffer_size_ = 0;
+                return true;
+            }
+
+            auto do_buffered() const noexcept -> span<const byte> {
+                return {buffer_.data(), buffer_size_};
+            }
+
+            auto do_partial_block() noexcept -> partial_block {
+                return {buffer_.data(), buffer_size_, total_size_};
+            }
+
             HASHLIB_ALWAYS_INLINE
             static auto unit_to_bytes(std::uint32_t unit) noexcept -> std::array<byte, 4> {
                 byte* byte_ptr = reinterpret_cast<byte*>(&unit);
@@ -145,15 +160,10 @@ namespace hashlib {
                 d_ += d;
             }
 
-            template<typename RandomAccessIt>
-            static auto w_table_(RandomAccessIt it) noexcept -> std::array<std::uint32_t, 16> {
-                static_assert(is_random_access_iterator<RandomAccessIt>::value, "unexpected");
+            static auto w_table_(const byte* block) noexcept -> std::array<std::uint32_t, 16> {
                 std::array<std::uint32_t, 16> w; // NOLINT(*-pro-type-member-init)
                 for (std::size_t i = 0; i < 16; ++i) {
-                    w[i] = (std::uint32_t(it[i * 4])) |
-                           (std::uint32_t(it[i * 4 + 1]) << 8) |
-                           (std::uint32_t(it[i * 4 + 2]) << 16) |
-                           (std::uint32_t(it[i * 4 + 3]) << 24);
+                    w[i] = load_le32(block + i * 4);
                 }
                 return w;
             }
@@ -0,0 +1,176 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include "executor.hpp"
+#include <tuple>
+#endif
+
+namespace hashlib {
+    namespace detail {
+        template<std::size_t I = 0, typename Tuple, typename F, enable_if_t<
+            I == std::tuple_size<Tuple>::value
+        >* = nullptr>
+        auto tuple_for_each(Tuple&, F&) -> void {}
+
+        template<std::size_t I = 0, typename Tuple, typename F, enable_if_t<
+            I < std::tuple_size<Tuple>::value
+        >* = nullptr>
+        auto tuple_for_each(Tuple& tuple, F& f) -> void {
+            f(std::get<I>(tuple));
+            tuple_for_each<I + 1>(tuple, f);
+        }
+
+        constexpr auto digest_size_sum() -> std::size_t {
+            return 0;
+        }
+
+        template<typename Algo, typename... Algos>
+        constexpr auto digest_size_sum(Algo*, Algos*... algos) -> std::size_t {
+            return Algo::digest_size + digest_size_sum(algos...);
+        }
+
+        // every member algorithm gets a chunk while it is still in the l1 cache, before the next chunk is loaded.
+        HASHLIB_CXX17_INLINE constexpr std::size_t multi_chunk_size = 16384;
+
+        template<typename... Algos>
+        class multi_base {
+        public:
+            static constexpr std::size_t digest_size = digest_size_sum(static_cast<Algos*>(nullptr)...);
+
+        public:
+            auto update(span<const byte> bytes) noexcept -> void {
+                while (bytes.size() > 0) {
+                    auto n = (std::min)(bytes.size(), std::size_t(multi_chunk_size));
+                    update_each chunk{{bytes.data(), n}};
+                    tuple_for_each(contexts_, chunk);
+                    bytes = {bytes.data() + n, bytes.size() - n};
+                }
+            }
+
+        protected:
+            // the digests of the member algorithms one after another.
+            auto do_digest() noexcept -> std::array<byte, digest_size> {
+                std::array<byte, digest_size> result; // NOLINT(*-pro-type-member-init)
+                concat_digests concat{result.data()};
+                tuple_for_each(contexts_, concat);
+                return result;
+            }
+
+            auto do_put(const byte* data, std::size_t n) noexcept -> void {
+                put_each each{{data, n}};
+                tuple_for_each(contexts_, each);
+            }
+
+            static auto unit_to_bytes(byte unit) noexcept -> std::array<byte, 1> {
+                return {{unit}};
+            }
+
+        protected:
+            struct update_each {
+                span<const byte> bytes;
+
+                template<typename Context>
+                auto operator()(Context& ctx) const noexcept -> void {
+                    ctx.update(bytes);
+                }
+            };
+
+            struct put_each {
+                span<const byte> bytes;
+
+                template<typename Context>
+                auto operator()(Context& ctx) const noexcept -> void {
+                    ctx.put(bytes);
+                }
+            };
+
+            struct concat_digests {
+                byte* out;
+
+                template<typename Context>
+                auto operator()(Context& ctx) noexcept -> void {
+                    auto digest = ctx.digest();
+                    out = std::copy(digest.begin(), digest.end(), out);
+                }
+            };
+
+        protected:
+            std::tuple<Algos...> contexts_;
+        };
+
+        template<typename... Algos>
+        constexpr std::size_t multi_base<Algos...>::digest_size;
+    }
+
+    // hashes the same data with several algorithms in a single pass, e.g. `hashlib::multi<md5, sha1, sha256>`.
+    // the data is fed to every algorithm a cache-sized chunk at a time, so it is loaded from memory only once.
+    // `digests()` returns the tuple of the digests, `digest()` returns them concatenated.
+    HASHLIB_MOD_EXPORT template<typename... Algos>
+    class multi : public context<detail::multi_base<Algos...>> {
+    public:
+        using context<detail::multi_base<Algos...>>::context;
+        using context<detail::multi_base<Algos...>>::update;
+
+        multi() = default;
+
+        // hashes `bytes` with every algorithm as a separate task run by `executor` and waits for them, this only pays
+        // off for inputs of several megabytes. see `is_executor`.
+        template<typename Executor, detail::enable_if_t<is_executor<Executor>::value>* = nullptr>
+        auto update(span<const byte> bytes, const Executor& executor) -> void {
+            detail::task_latch latch{sizeof...(Algos)};
+            submit_update<Executor> submit{executor, bytes, latch, 0};
+            try {
+                detail::tuple_for_each(this->contexts_, submit);
+            } catch (...) {
+                latch.count_down(sizeof...(Algos) - submit.submitted);
+                latch.wait();
+                throw;
+            }
+            latch.wait();
+        }
+
+        HASHLIB_NODISCARD auto digests() noexcept -> std::tuple<std::array<byte, Algos::digest_size>...> {
+            return digests_(detail::make_index_sequence<sizeof...(Algos)>{});
+        }
+
+        HASHLIB_NODISCARD auto hexdigests() -> std::array<std::string, sizeof...(Algos)> {
+            return hexdigests_(detail::make_index_sequence<sizeof...(Algos)>{});
+        }
+
+        // a copy of the member algorithm at `I`.
+        template<std::size_t I>
+        HASHLIB_NODISCARD auto get() const noexcept -> typename std::tuple_element<I, std::tuple<Algos...>>::type {
+            return std::get<I>(this->contexts_);
+        }
+
+    private:
+        template<typename Executor>
+        struct submit_update {
+            const Executor& executor;
+            span<const byte> bytes;
+            detail::task_latch& latch;
+            std::size_t submitted;
+
+            template<typename Context>
+            auto operator()(Context& ctx) -> void {
+                auto bytes_ = bytes;
+                auto& latch_ = latch;
+                executor.execute([&ctx, bytes_, &latch_] {
+                    ctx.update(bytes_);
+                    latch_.count_down();
+                });
+                ++submitted;
+            }
+        };
+
+        template<std::size_t... Is>
+        auto digests_(detail::index_sequence<Is...>) noexcept -> std::tuple<std::array<byte, Algos::digest_size>...> {
+            return std::make_tuple(std::get<Is>(this->contexts_).digest()...);
+        }
+
+        template<std::size_t... Is>
+        auto hexdigests_(detail::index_sequence<Is...>) -> std::array<std::string, sizeof...(Algos)> {
+            return {{std::get<Is>(this->contexts_).hexdigest()...}};
+        }
+    };
+}
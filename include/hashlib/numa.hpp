@@ -0,0 +1,156 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace hashlib {
+    // where a thread runs or memory is placed, -1 when it is unknown or not fixed.
+    // the numa support reads the topology from sysfs and uses the raw system calls, so it does not depend on libnuma.
+    // on other platforms, or when the topology is unknown, there is a single node and nothing is pinned or bound.
+    HASHLIB_MOD_EXPORT struct numa_placement {
+        int cpu = -1;
+        int node = -1;
+    };
+
+    namespace detail {
+        // parses a sysfs list such as "0-3,8-11".
+        inline auto parse_cpu_list(const std::string& list) -> std::vector<int> {
+            std::vector<int> result;
+            std::size_t i = 0;
+            while (i < list.size()) {
+                std::size_t end;
+                int first, last;
+                try {
+                    first = last = std::stoi(list.substr(i), &end);
+                    i += end;
+                    if (i < list.size() && list[i] == '-') {
+                        last = std::stoi(list.substr(++i), &end);
+                        i += end;
+                    }
+                } catch (const std::logic_error&) {
+                    break;
+                }
+                for (int cpu = first; cpu <= last; ++cpu) result.push_back(cpu);
+                while (i < list.size() && (list[i] == ',' || list[i] == '\n' || list[i] == ' ')) ++i;
+            }
+            return result;
+        }
+
+        struct numa_topology {
+            // the cpus of every node, indexed by node id, empty for nodes without cpus.
+            std::vector<std::vector<int>> node_cpus;
+            // the node of every cpu, indexed by cpu id, -1 if unknown.
+            std::vector<int> cpu_node;
+        };
+
+        inline auto load_numa_topology() -> numa_topology {
+            numa_topology topology;
+#if defined(__linux__)
+            std::string list;
+            std::ifstream online{"/sys/devices/system/node/online"};
+            if (online && std::getline(online, list)) {
+                for (int node : parse_cpu_list(list)) {
+                    std::ifstream file{"/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"};
+                    std::string cpus;
+                    if (!file || !std::getline(file, cpus)) continue;
+                    if (topology.node_cpus.size() <= static_cast<std::size_t>(node)) topology.node_cpus.resize(node + 1);
+                    topology.node_cpus[node] = parse_cpu_list(cpus);
+                    for (int cpu : topology.node_cpus[node]) {
+                        if (topology.cpu_node.size() <= static_cast<std::size_t>(cpu)) topology.cpu_node.resize(cpu + 1, -1);
+                        topology.cpu_node[cpu] = node;
+                    }
+                }
+            }
+#endif
+            return topology;
+        }
+
+        inline auto get_numa_topology() -> const numa_topology& {
+            static const numa_topology topology = load_numa_topology();
+            return topology;
+        }
+
+        inline auto numa_node_of_cpu(int cpu) -> int {
+            const auto& cpu_node = get_numa_topology().cpu_node;
+            return cpu >= 0 && static_cast<std::size_t>(cpu) < cpu_node.size() ? cpu_node[cpu] : -1;
+        }
+
+        // the cpus ordered so that consecutive ones belong to different nodes, in order to spread workers evenly.
+        inline auto interleaved_cpus() -> std::vector<int> {
+            const auto& node_cpus = get_numa_topology().node_cpus;
+            std::vector<int> result;
+            for (std::size_t i = 0;; ++i) {
+                bool any = false;
+                for (const auto& cpus : node_cpus) {
+                    if (i >= cpus.size()) continue;
+                    result.push_back(cpus[i]);
+                    any = true;
+                }
+                if (!any) break;
+            }
+            return result;
+        }
+
+        inline auto pin_current_thread(int cpu) noexcept -> bool {
+#if defined(__linux__) && defined(CPU_SET)
+            if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+            (void)cpu;
+            return false;
+#endif
+        }
+
+        // asks the kernel to take the pages of `[addr, addr + size)` from `node` when they are first touched.
+        inline auto prefer_numa_node(void* addr, std::size_t size, int node) noexcept -> bool {
+#if defined(__linux__) && defined(SYS_mbind)
+            constexpr int mpol_preferred = 1;
+            constexpr std::size_t mask_bits = 8 * sizeof(unsigned long);
+            if (node < 0 || static_cast<std::size_t>(node) >= 16 * mask_bits) return false;
+            if (get_numa_topology().node_cpus.size() < 2) return false;
+            unsigned long mask[16] = {};
+            mask[node / mask_bits] = 1ul << (node % mask_bits);
+            return ::syscall(SYS_mbind, addr, size, mpol_preferred, mask, 16 * mask_bits, 0) == 0;
+#else
+            (void)addr;
+            (void)size;
+            (void)node;
+            return false;
+#endif
+        }
+    }
+
+    // the number of numa nodes with cpus, at least 1.
+    HASHLIB_MOD_EXPORT inline auto numa_node_count() -> std::size_t {
+        std::size_t count = 0;
+        for (const auto& cpus : detail::get_numa_topology().node_cpus) {
+            if (!cpus.empty()) ++count;
+        }
+        return (std::max)(count, std::size_t(1));
+    }
+
+    // the cpu and the node the calling thread is running on right now.
+    HASHLIB_MOD_EXPORT inline auto current_numa_placement() noexcept -> numa_placement {
+        numa_placement placement;
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0, node = 0;
+        if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+            placement.cpu = static_cast<int>(cpu);
+            placement.node = static_cast<int>(node);
+        }
+#endif
+        return placement;
+    }
+}
@@ -0,0 +1,353 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "file.hpp"
+#include "executor.hpp"
+#include <exception>
+#endif
+
+namespace hashlib {
+    // options of the parallel file hasher, see `hash_files`.
+    HASHLIB_MOD_EXPORT struct parallel_options {
+        // number of worker threads of the pool used when no executor is given,
+        // 0 means `std::thread::hardware_concurrency()`.
+        std::size_t threads = 0;
+        // pin the workers of that pool to cpus spread over the numa nodes, see `thread_pool_options`.
+        bool pin_threads = false;
+        // regular files at least this large are split into chunks, each chunk being read by a separate task.
+        std::uint64_t large_file_threshold = std::uint64_t(64) << 20;
+        // size of the chunks of large files.
+        std::size_t chunk_size = std::size_t(2) << 20;
+        // number of chunks of a large file which are read ahead of the hashing.
+        std::size_t read_ahead = 4;
+        // maximum number of consecutive paths handled by one task, the smaller files among them are hashed by the task
+        // itself. fewer paths are grouped when there are not enough files to keep every worker busy.
+        std::size_t paths_per_task = 16;
+        // for debugging, called with the index of every large file and the placement of its buffers, which is the cpu
+        // and the numa node of the worker which opened the file. the chunks are read into memory of that node, and the
+        // reads are submitted to that worker, from which the workers of the same node steal first.
+        std::function<void(std::size_t, const numa_placement&)> on_placement;
+    };
+
+    // the digest and the error of one file hashed by `hash_files`.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    struct file_hash_result {
+        Algo context;
+        std::error_code ec;
+    };
+
+    namespace detail {
+        HASHLIB_CXX17_INLINE constexpr std::size_t chunk_not_filled = static_cast<std::size_t>(-1);
+
+        // shall be called in a handler, maps the exception thrown by an executor to an error code.
+        inline auto current_exception_code() noexcept -> std::error_code {
+            try {
+                throw;
+            } catch (const std::system_error& e) {
+                return e.code();
+            } catch (const std::bad_alloc&) {
+                return std::make_error_code(std::errc::not_enough_memory);
+            } catch (...) {
+                return std::make_error_code(std::errc::resource_unavailable_try_again);
+            }
+        }
+
+        template<typename Algo, typename Executor, typename Callback>
+        class parallel_file_hasher {
+        public:
+            parallel_file_hasher(
+                const std::vector<std::string>& paths,
+                const Executor& executor,
+                Callback& on_complete,
+                const parallel_options& options
+            ) : paths_(paths), executor_(executor), on_complete_(on_complete), options_(options), remaining_(paths.size()) {
+                options_.chunk_size = (std::max)(options_.chunk_size, std::size_t(1));
+                options_.read_ahead = (std::max)(options_.read_ahead, std::size_t(1));
+            }
+
+            // blocks until every file is done, so it shall not be called by a task of an executor which runs one task
+            // at a time.
+            auto run() -> void {
+                if (paths_.empty()) return;
+                // groups of paths are small enough to give every worker several tasks
+                auto per_task = paths_.size() / (executor_concurrency(executor_) * 4);
+                per_task = (std::max)((std::min)(per_task, options_.paths_per_task), std::size_t(1));
+                std::size_t first = 0;
+                try {
+                    for (; first < paths_.size(); first += per_task) {
+                        auto last = (std::min)(first + per_task, paths_.size());
+                        executor_.execute([this, first, last] { hash_paths_(first, last); });
+                    }
+                } catch (...) {
+                    // wait for the tasks already submitted, which refer to this object
+                    std::unique_lock<std::mutex> lock{mutex_};
+                    remaining_ -= paths_.size() - first;
+                    done_.wait(lock, [this] { return remaining_ == 0; });
+                    throw;
+                }
+                {
+                    std::unique_lock<std::mutex> lock{mutex_};
+                    done_.wait(lock, [this] { return remaining_ == 0; });
+                }
+                if (exception_) std::rethrow_exception(exception_);
+            }
+
+        private:
+#if HASHLIB_PLATFORM_POSIX
+            // the chunks of a large file are read concurrently into a ring of `read_ahead` slots and hashed in order by
+            // whichever task completes the next expected chunk.
+            struct large_file {
+                std::size_t index;
+                int fd;
+                std::uint64_t size;
+                std::size_t chunks;
+                Algo ctx;
+                std::mutex mutex;
+                std::vector<aligned_buffer> slots;
+                std::vector<std::size_t> filled;
+                std::size_t next_read = 0;
+                std::size_t next_hash = 0;
+                std::size_t reading = 0;
+                bool hashing = false;
+                bool finished = false;
+                std::error_code ec;
+
+                ~large_file() {
+                    ::close(fd);
+                }
+            };
+#endif
+
+            auto complete_(std::size_t index, Algo& ctx, std::error_code ec) noexcept -> void {
+                {
+                    std::lock_guard<std::mutex> lock{callback_mutex_};
+                    try {
+                        on_complete_(index, ctx, ec);
+                    } catch (...) {
+                        if (!exception_) exception_ = std::current_exception();
+                    }
+                }
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (--remaining_ == 0) done_.notify_all();
+            }
+
+            auto hash_paths_(std::size_t first, std::size_t last) noexcept -> void {
+                for (auto i = first; i < last; ++i) {
+                    Algo ctx;
+                    std::error_code ec;
+                    try {
+                        if (hash_path_(i, ctx, ec)) continue;
+                    } catch (const std::bad_alloc&) {
+                        ec = std::make_error_code(std::errc::not_enough_memory);
+                    }
+                    complete_(i, ctx, ec);
+                }
+            }
+
+            // returns true if the file is handed over to large file tasks.
+            auto hash_path_(std::size_t index, Algo& ctx, std::error_code& ec) -> bool {
+#if HASHLIB_PLATFORM_POSIX
+                int fd = open_read_only(paths_[index]);
+                if (fd < 0) {
+                    ec = last_error_code();
+                    return false;
+                }
+                struct stat st{};
+                if (::fstat(fd, &st) != 0) {
+                    ec = last_error_code();
+                    ::close(fd);
+                    return false;
+                }
+                if (S_ISREG(st.st_mode) && static_cast<std::uint64_t>(st.st_size) >= options_.large_file_threshold) {
+                    std::shared_ptr<large_file> file;
+                    try {
+                        file = std::make_shared<large_file>();
+                    } catch (...) {
+                        ::close(fd);
+                        throw;
+                    }
+                    file->index = index;
+                    file->fd = fd;
+                    file->size = static_cast<std::uint64_t>(st.st_size);
+                    file->chunks = static_cast<std::size_t>((file->size + options_.chunk_size - 1) / options_.chunk_size);
+                    // the buffers are mapped but not touched yet, their pages are taken from the node of this worker
+                    auto placement = current_numa_placement();
+                    auto slots = (std::min)(options_.read_ahead, file->chunks);
+                    file->slots.reserve(slots);
+                    for (std::size_t i = 0; i < slots; ++i) {
+                        file->slots.emplace_back(options_.chunk_size, false, placement.node);
+                    }
+                    file->filled.assign(slots, chunk_not_filled);
+                    if (options_.on_placement) {
+                        std::lock_guard<std::mutex> lock{callback_mutex_};
+                        try {
+                            options_.on_placement(index, placement);
+                        } catch (...) {
+                            if (!exception_) exception_ = std::current_exception();
+                        }
+                    }
+                    // the lock is not held while submitting, the executor may run the task right away
+                    auto initial = file->slots.size();
+                    file->next_read = file->reading = initial;
+                    for (std::size_t chunk = 0; chunk < initial; ++chunk) {
+                        if (submit_read_(file, chunk)) continue;
+                        std::unique_lock<std::mutex> lock{file->mutex};
+                        file->reading -= initial - chunk - 1;
+                        drive_(file, lock);
+                        break;
+                    }
+                    return true;
+                }
+                file_descriptor guard{fd};
+                hash_fd_impl(ctx, fd, st, ec);
+#else
+                hash_file_impl(ctx, paths_[index], ec);
+#endif
+                return false;
+            }
+
+#if HASHLIB_PLATFORM_POSIX
+            // the read shall be counted in `file->reading`, it is uncounted again if it cannot be submitted.
+            auto submit_read_(const std::shared_ptr<large_file>& file, std::size_t chunk) noexcept -> bool {
+                try {
+                    executor_.execute([this, file, chunk] { read_chunk_(file, chunk); });
+                    return true;
+                } catch (...) {
+                    auto ec = current_exception_code();
+                    std::lock_guard<std::mutex> lock{file->mutex};
+                    --file->reading;
+                    if (!file->ec) file->ec = ec;
+                    return false;
+                }
+            }
+
+            auto read_chunk_(const std::shared_ptr<large_file>& file, std::size_t chunk) noexcept -> void {
+                auto offset = static_cast<std::uint64_t>(chunk) * options_.chunk_size;
+                auto length = static_cast<std::size_t>((std::min<std::uint64_t>)(file->size - offset, options_.chunk_size));
+                auto slot = chunk % file->slots.size();
+                std::error_code ec;
+                std::size_t done = 0;
+                // the file may shrink meanwhile, then the missing bytes are not hashed
+                while (done < length) {
+                    auto n = ::pread(file->fd, file->slots[slot].data() + done, length - done, static_cast<off_t>(offset + done));
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0) {
+                        ec = last_error_code();
+                        break;
+                    }
+                    if (n == 0) break;
+                    done += static_cast<std::size_t>(n);
+                }
+
+                std::unique_lock<std::mutex> lock{file->mutex};
+                --file->reading;
+                if (ec) {
+                    if (!file->ec) file->ec = ec;
+                } else {
+                    file->filled[slot] = done;
+                }
+                drive_(file, lock);
+            }
+
+            // hashes the chunks which are ready in order and refills their slots.
+            auto drive_(const std::shared_ptr<large_file>& file, std::unique_lock<std::mutex>& lock) noexcept -> void {
+                if (!file->hashing) {
+                    file->hashing = true;
+                    while (!file->ec && file->next_hash < file->chunks) {
+                        auto slot = file->next_hash % file->slots.size();
+                        auto size = file->filled[slot];
+                        if (size == chunk_not_filled) break;
+                        lock.unlock();
+                        file->ctx.update({file->slots[slot].data(), size});
+                        lock.lock();
+                        file->filled[slot] = chunk_not_filled;
+                        ++file->next_hash;
+                        if (file->next_read < file->chunks) {
+                            auto chunk = file->next_read++;
+                            ++file->reading;
+                            lock.unlock();
+                            submit_read_(file, chunk);
+                            lock.lock();
+                        }
+                    }
+                    file->hashing = false;
+                }
+                if (file->finished || file->reading > 0 || (!file->ec && file->next_hash < file->chunks)) return;
+                file->finished = true;
+                lock.unlock();
+                complete_(file->index, file->ctx, file->ec);
+            }
+#endif
+
+        private:
+            const std::vector<std::string>& paths_;
+            Executor executor_;
+            Callback& on_complete_;
+            parallel_options options_;
+            std::mutex callback_mutex_;
+            std::exception_ptr exception_;
+            std::mutex mutex_;
+            std::condition_variable done_;
+            std::size_t remaining_;
+        };
+    }
+
+    // hashes many files with tasks run by `executor`, see `is_executor`.
+    // `on_complete(index, ctx, ec)` is called as soon as each file is done, so in any order, but never concurrently.
+    // the first exception thrown by `on_complete` is rethrown once every file is done.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Executor, typename Callback, detail::enable_if_t<
+        is_executor<Executor>::value &&
+        !std::is_same<detail::remove_cvref_t<Callback>, parallel_options>::value
+    >* = nullptr>
+    auto hash_files(
+        const std::vector<std::string>& paths,
+        const Executor& executor,
+        Callback&& on_complete,
+        const parallel_options& options = {}
+    ) -> void {
+        detail::parallel_file_hasher<Algo, Executor, detail::remove_reference_t<Callback>>{
+            paths, executor, on_complete, options
+        }.run();
+    }
+
+    // hashes many files with tasks run by `executor`, the results are in the order of `paths`.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Executor, detail::enable_if_t<
+        is_executor<Executor>::value
+    >* = nullptr>
+    HASHLIB_NODISCARD auto hash_files(
+        const std::vector<std::string>& paths,
+        const Executor& executor,
+        const parallel_options& options = {}
+    ) -> std::vector<file_hash_result<Algo>> {
+        std::vector<file_hash_result<Algo>> results(paths.size());
+        hash_files<Algo>(paths, executor, [&results](std::size_t index, Algo& ctx, std::error_code ec) {
+            results[index].context = ctx;
+            results[index].ec = ec;
+        }, options);
+        return results;
+    }
+
+    // hashes many files on a `thread_pool` of `options.threads` workers.
+    // `on_complete(index, ctx, ec)` is called as soon as each file is done, so in any order, but never concurrently.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename Callback, detail::enable_if_t<
+        !is_executor<Callback>::value &&
+        !std::is_same<detail::remove_cvref_t<Callback>, parallel_options>::value
+    >* = nullptr>
+    auto hash_files(const std::vector<std::string>& paths, Callback&& on_complete, const parallel_options& options = {}) -> void {
+        thread_pool_options pool_options;
+        pool_options.threads = options.threads;
+        pool_options.pin_threads = options.pin_threads;
+        thread_pool pool{pool_options};
+        hash_files<Algo>(paths, pool.get_executor(), std::forward<Callback>(on_complete), options);
+    }
+
+    // hashes many files on a `thread_pool` of `options.threads` workers, the results are in the order of `paths`.
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    HASHLIB_NODISCARD auto hash_files(const std::vector<std::string>& paths, const parallel_options& options = {})
+        -> std::vector<file_hash_result<Algo>> {
+        thread_pool_options pool_options;
+        pool_options.threads = options.threads;
+        pool_options.pin_threads = options.pin_threads;
+        thread_pool pool{pool_options};
+        return hash_files<Algo>(paths, pool.get_executor(), options);
+    }
+}
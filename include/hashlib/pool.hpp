@@ -0,0 +1,283 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include <vector>
+#endif
+
+namespace hashlib {
+    // a large number of concurrent streams of `Algo`, e.g. one per upload in flight. the chaining states, the sizes and
+    // the partial blocks are kept in three separate arrays indexed by handle, so the hot states stay together in the
+    // cache. a batch of writes to different streams is compressed several streams at a time when the algorithm has a
+    // multi-buffer kernel, sha-224 and sha-256 have one, the other algorithms compress one stream after another.
+    template<typename Algo>
+    class context_pool {
+    public:
+        // handles are reused once they are closed.
+        using handle = std::size_t;
+
+        struct write {
+            handle stream;
+            span<const byte> bytes;
+        };
+
+        static constexpr std::size_t digest_size = Algo::digest_size;
+        static constexpr std::size_t block_size = Algo::block_size;
+
+    public:
+        context_pool() = default;
+
+        // room for `capacity` streams without reallocating.
+        explicit context_pool(std::size_t capacity) {
+            reserve(capacity);
+        }
+
+        auto reserve(std::size_t capacity) -> void {
+            states_.reserve(capacity);
+            sizes_.reserve(capacity);
+            buffers_.reserve(capacity * block_size);
+            marks_.reserve(capacity);
+        }
+
+        // the number of open streams.
+        HASHLIB_NODISCARD auto size() const noexcept -> std::size_t {
+            return states_.size() - free_.size();
+        }
+
+        // a new empty stream.
+        HASHLIB_NODISCARD auto open() -> handle {
+            if (!free_.empty()) {
+                auto stream = free_.back();
+                free_.pop_back();
+                states_[stream] = initial_state_();
+                sizes_[stream] = 0;
+                marks_[stream] = 0;
+                // the partial block of the previous stream, `open(prefix)` relies on an empty one
+                std::fill_n(buffers_.data() + stream * block_size, block_size, byte{0});
+                return stream;
+            }
+            states_.push_back(initial_state_());
+            sizes_.push_back(0);
+            buffers_.resize(buffers_.size() + block_size);
+            marks_.push_back(0);
+            return states_.size() - 1;
+        }
+
+        // a new stream which continues from `prefix`, e.g. a common header hashed once. the partial block of `prefix` is
+        // either its buffered bytes or, for sha3, already xored into its midstate. in that case the slot of the stream
+        // stays zero, so that xoring the completed block into the state adds only the bytes written to the stream.
+        HASHLIB_NODISCARD auto open(const Algo& prefix) -> handle {
+            auto stream = open();
+            auto midstate = prefix.do_midstate();
+            auto buffered = prefix.do_buffered();
+            states_[stream] = midstate.state;
+            sizes_[stream] = midstate.size + buffered.size();
+            std::copy(buffered.begin(), buffered.end(), buffers_.data() + stream * block_size);
+            return stream;
+        }
+
+        auto close(handle stream) -> void {
+            free_.push_back(stream);
+        }
+
+        auto update(handle stream, span<const byte> bytes) -> void {
+            write one{stream, bytes};
+            update({&one, 1});
+        }
+
+        // appends the bytes of every write to its stream, in order. a stream may appear several times.
+        auto update(span<const write> writes) -> void {
+            ++round_;
+            for (const auto& w : writes) {
+                if (marks_[w.stream] == round_) {
+                    // the blocks of a stream depend on each other, so a round has at most one job per stream
+                    run_jobs_();
+                    ++round_;
+                }
+                marks_[w.stream] = round_;
+                add_job_(w.stream, w.bytes);
+            }
+            run_jobs_();
+        }
+
+        HASHLIB_NODISCARD auto digest(handle stream) const -> std::array<byte, digest_size> {
+            return context_(stream).digest();
+        }
+
+        HASHLIB_NODISCARD auto hexdigest(handle stream) const -> std::string {
+            return context_(stream).hexdigest();
+        }
+
+        // the digests of several distinct streams, their last blocks are compressed together on the lanes as well,
+        // which matters for short messages. the streams are left as they were.
+        auto digests(span<const handle> streams, std::array<byte, digest_size>* out) -> void {
+            digests_(streams, out, static_cast<kernel*>(nullptr));
+        }
+
+    private:
+        using midstate_type = typename Algo::midstate_type;
+        using state_type = decltype(std::declval<midstate_type&>().state);
+        using kernel = typename detail::lane_kernel<Algo>::type;
+
+        // the blocks of one stream to compress, the completed partial block first, then whole blocks of the input.
+        struct job {
+            handle stream;
+            const byte* first;
+            const byte* blocks;
+            std::size_t blocks_count;
+            const byte* tail;
+            std::size_t tail_size;
+
+            auto has_block() const noexcept -> bool {
+                return first != nullptr || blocks_count > 0;
+            }
+
+            auto next_block() noexcept -> const byte* {
+                if (first != nullptr) {
+                    auto block = first;
+                    first = nullptr;
+                    return block;
+                }
+                auto block = blocks;
+                blocks += block_size;
+                --blocks_count;
+                return block;
+            }
+        };
+
+        static auto initial_state_() -> state_type {
+            return Algo{}.midstate().state;
+        }
+
+        auto context_(handle stream) const -> Algo {
+            auto buffered = static_cast<std::size_t>(sizes_[stream] % block_size);
+            auto ctx = Algo::from_midstate({states_[stream], sizes_[stream] - buffered});
+            ctx.update({buffers_.data() + stream * block_size, buffered});
+            return ctx;
+        }
+
+        auto add_job_(handle stream, span<const byte> bytes) -> void {
+            auto data = bytes.data();
+            auto n = bytes.size();
+            auto buffered = static_cast<std::size_t>(sizes_[stream] % block_size);
+            auto buffer = buffers_.data() + stream * block_size;
+            sizes_[stream] += n;
+            job j{stream, nullptr, nullptr, 0, nullptr, 0};
+            if (buffered > 0) {
+                auto to_copy = (std::min)(n, block_size - buffered);
+                std::copy_n(data, to_copy, buffer + buffered);
+                data += to_copy;
+                n -= to_copy;
+                if (buffered + to_copy < block_size) return;
+                j.first = buffer;
+            }
+            j.blocks = data;
+            j.blocks_count = n / block_size;
+            j.tail = data + j.blocks_count * block_size;
+            j.tail_size = n % block_size;
+            jobs_.push_back(j);
+        }
+
+        auto run_jobs_() -> void {
+            run_lanes_(static_cast<kernel*>(nullptr));
+            for (auto& j : jobs_) {
+                if (j.has_block()) {
+                    auto ctx = Algo::from_midstate({states_[j.stream], 0});
+                    while (j.has_block()) ctx.update({j.next_block(), block_size});
+                    states_[j.stream] = ctx.midstate().state;
+                }
+                // the partial block is overwritten only now that it is compressed
+                std::copy_n(j.tail, j.tail_size, buffers_.data() + j.stream * block_size);
+            }
+            jobs_.clear();
+        }
+
+        auto digests_(span<const handle> streams, std::array<byte, digest_size>* out, void*) -> void {
+            for (std::size_t i = 0; i < streams.size(); ++i) out[i] = digest(streams[i]);
+        }
+
+        template<typename Kernel>
+        auto digests_(span<const handle> streams, std::array<byte, digest_size>* out, Kernel*) -> void {
+            constexpr std::size_t padded_size = Kernel::max_padding_blocks * block_size;
+            std::vector<byte> padded(streams.size() * padded_size);
+            std::vector<state_type> saved;
+            saved.reserve(streams.size());
+            for (std::size_t i = 0; i < streams.size(); ++i) {
+                auto stream = streams[i];
+                auto buffered = static_cast<std::size_t>(sizes_[stream] % block_size);
+                auto blocks = padded.data() + i * padded_size;
+                auto count = Kernel::pad(buffers_.data() + stream * block_size, buffered, sizes_[stream], blocks);
+                saved.push_back(states_[stream]);
+                jobs_.push_back(job{stream, nullptr, blocks, count, nullptr, 0});
+            }
+            run_jobs_();
+            using word_type = typename Kernel::word_type;
+            for (std::size_t i = 0; i < streams.size(); ++i) {
+                auto stream = streams[i];
+                for (std::size_t j = 0; j * sizeof(word_type) < digest_size; ++j) {
+                    Kernel::store_word(states_[stream][j], out[i].data() + j * sizeof(word_type));
+                }
+                states_[stream] = saved[i];
+            }
+        }
+
+        auto run_lanes_(void*) -> void {}
+
+        // every lane takes the blocks of one job until it has none left, and then the next job. once the jobs run out
+        // and fewer than half of the lanes are busy, the remaining blocks are left to the one stream at a time path.
+        template<typename Kernel>
+        auto run_lanes_(Kernel*) -> void {
+            constexpr std::size_t lanes = Kernel::lanes;
+            constexpr std::size_t words = std::tuple_size<state_type>::value;
+            static const byte idle_block[block_size] = {};
+            typename Kernel::word_type state[words * lanes] = {};
+            const byte* blocks[lanes];
+            job* busy[lanes] = {};
+            std::size_t busy_count = 0;
+            std::size_t next = 0;
+            for (;;) {
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    while (busy[l] == nullptr && next < jobs_.size()) {
+                        if (!jobs_[next].has_block()) {
+                            ++next;
+                            continue;
+                        }
+                        busy[l] = &jobs_[next++];
+                        ++busy_count;
+                        for (std::size_t i = 0; i < words; ++i) state[i * lanes + l] = states_[busy[l]->stream][i];
+                    }
+                }
+                if (next == jobs_.size() && 2 * busy_count < lanes) break;
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    blocks[l] = busy[l] != nullptr ? busy[l]->next_block() : idle_block;
+                }
+                Kernel::compress(state, blocks);
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    if (busy[l] == nullptr || busy[l]->has_block()) continue;
+                    for (std::size_t i = 0; i < words; ++i) states_[busy[l]->stream][i] = state[i * lanes + l];
+                    busy[l] = nullptr;
+                    --busy_count;
+                }
+            }
+            for (std::size_t l = 0; l < lanes; ++l) {
+                if (busy[l] == nullptr) continue;
+                for (std::size_t i = 0; i < words; ++i) states_[busy[l]->stream][i] = state[i * lanes + l];
+            }
+        }
+
+    private:
+        std::vector<state_type> states_;
+        std::vector<std::uint64_t> sizes_;
+        std::vector<byte> buffers_;
+        // the round in which a stream last got a job.
+        std::vector<std::size_t> marks_;
+        std::size_t round_ = 0;
+        std::vector<handle> free_;
+        std::vector<job> jobs_;
+    };
+
+    template<typename Algo>
+    constexpr std::size_t context_pool<Algo>::digest_size;
+
+    template<typename Algo>
+    constexpr std::size_t context_pool<Algo>::block_size;
+}
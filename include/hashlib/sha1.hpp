@@ -8,44 +8,20 @@ namespace hashlib {
         class sha1 {
         public:
             static constexpr std::size_t digest_size = 20;
+            static constexpr std::size_t block_size = 64;
+            using state_type = std::array<std::uint32_t, 5>;
 
         public:
             sha1() noexcept : h_{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0} {}
 
             auto update(span<const byte> bytes) noexcept -> void {
-                update(bytes.begin(), bytes.end());
-            }
-
-            template<typename InputIt, typename Sentinel, enable_if_t<
-                is_input_iterator<InputIt>::value &&
-                !is_random_access_iterator<InputIt>::value &&
-                is_sentinel_for<Sentinel, InputIt>::value &&
-                is_byte_like<iter_value_t<InputIt>>::value
-            >* = nullptr>
-            auto update(InputIt first, Sentinel last) -> void {
-                byte temp[128];
-                for (auto it = first; it != last;) {
-                    std::size_t n = 0;
-                    for (; it != last && n < sizeof(temp); ++it, ++n) {
-                        temp[n] = static_cast<byte>(*it);
-                    }
-                    update({temp, n});
-                }
-            }
-
-            template<typename RandomAccessIt, typename Sentinel, enable_if_t<
-                is_random_access_iterator<RandomAccessIt>::value &&
-                is_sentinel_for<Sentinel, RandomAccessIt>::value &&
-                is_byte_like<iter_value_t<RandomAccessIt>>::value
-            >* = nullptr>
-            auto update(RandomAccessIt first, Sentinel last) -> void {
-                std::size_t bytes_count = last - first;
+                std::size_t bytes_count = bytes.size();
                 total_size_ += bytes_count;
                 std::size_t i = 0;
 
                 if (buffer_size_ > 0) {
                     std::size_t to_copy = std::min(bytes_count, 64 - buffer_size_);
-                    std::copy_n(first, to_copy, buffer_.data() + buffer_size_);
+                    std::copy_n(bytes.data(), to_copy, buffer_.data() + buffer_size_);
                     buffer_size_ += to_copy;
                     i += to_copy;
                     if (buffer_size_ == 64) {
@@ -55,11 +31,11 @@ namespace hashlib {
                 }
 
                 for (; i + 63 < bytes_count; i += 64) {
-                    (process_)((w_table_)(std::next(first, i)));
+                    process_(w_table_(bytes.data() + i));
                 }
 
                 if (i < bytes_count) {
-                    std::copy_n(std::next(first, i), bytes_count - i, buffer_.data());
+                    std::copy_n(bytes.data() + i, bytes_count - i, buffer_.data());
                     buffer_size_ = bytes_count - i;
                 }
             }
@@ -82,6 +58,42 @@ namespace hashlib {
                 return h_;
             }
 
+            template<std::size_t N>
+            auto do_hash_fixed(const byte* data) noexcept -> std::array<std::uint32_t, 5> {
+                using padding = fixed_padding<N, 64, 8, true>;
+                for (std::size_t i = 0; i < padding::full_blocks; ++i) {
+                    process_(w_table_(data + i * 64));
+                }
+                if (padding::has_tail_block) {
+                    process_(w_table_(padding::tail_block(data + padding::full_blocks * 64).data()));
+                }
+                if (padding::has_constant_block) {
+                    static const auto w = w_table_(padding::constant_block().data());
+                    process_(w);
+                }
+                return h_;
+            }
+
+            auto do_midstate() const noexcept -> basic_midstate<state_type> {
+                return {h_, total_size_ - buffer_size_};
+            }
+
+            auto do_load_midstate(const basic_midstate<state_type>& midstate) noexcept -> bool {
+                if (midstate.size % block_size != 0) return false;
+                h_ = midstate.state;
+                total_size_ = midstate.size;
+                buffer_size_ = 0;
+                return true;
+            }
+
+            auto do_buffered() const noexcept -> span<const byte> {
+                return {buffer_.data(), buffer_size_};
+            }
+
+            auto do_partial_block() noexcept -> partial_block {
+                return {buffer_.data(), buffer_size_, total_size_};
+            }
+
             HASHLIB_ALWAYS_INLINE
             static auto unit_to_bytes(std::uint32_t unit) noexcept -> std::array<byte, 4> {
                 byte* byte_ptr = reinterpret_cast<byte*>(&unit);
@@ -129,15 +141,10 @@ namespace hashlib {
                 h_[4] += e;
             }
 
-            template<typename RandomAccessIt>
-            static auto w_table_(RandomAccessIt it) noexcept -> std::array<std::uint32_t, 80> {
-                static_assert(is_random_access_iterator<RandomAccessIt>::value, "unexpected");
+            static auto w_table_(const byte* block) noexcept -> std::array<std::uint32_t, 80> {
                 std::array<std::uint32_t, 80> w; // NOLINT(*-pro-type-member-init)
                 for (std::size_t i = 0; i < 16; ++i) {
-                    w[i] = (std::uint32_t(it[i * 4]) << 24) |
-                           (std::uint32_t(it[i * 4 + 1]) << 16) |
-                           (std::uint32_t(it[i * 4 + 2]) << 8) |
-                           (std::uint32_t(it[i * 4 + 3]));
+                    w[i] = load_be32(block + i * 4);
                 }
                 for (std::size_t i = 16; i < 80; ++i) {
                     const auto temp = w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16];
@@ -1,70 +1,231 @@
 #ifndef HASHLIB_ALL_IN_ONE
 #pragma once
 #include "core.hpp"
+#include "pool.hpp"
+#if defined(__SHA__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+#define HASHLIB_HAS_SHANI 1
+#else
+#define HASHLIB_HAS_SHANI 0
 #endif
 
 namespace hashlib {
+    // the compression functions of sha224 and sha256, chosen at compile time with `sha256_t<Kernel>`, e.g. for a
+    // build which targets known hardware. the aliases `sha224` and `sha256` use the portable one, so that the type
+    // does not depend on the target flags of the translation unit.
+    namespace kernel {
+        // plain c++, for any target.
+        HASHLIB_MOD_EXPORT struct portable {};
+
+#if HASHLIB_HAS_SHANI
+        // the x86 sha extensions, requires `-msha -msse4.1` or a `-march` which has them, e.g. `-march=icelake-server`.
+        HASHLIB_MOD_EXPORT struct shani {};
+#endif
+
+        // the fastest kernel the compiler targets, according to its target macros.
+#if HASHLIB_HAS_SHANI
+        HASHLIB_MOD_EXPORT using native = shani;
+#else
+        HASHLIB_MOD_EXPORT using native = portable;
+#endif
+    }
+
     namespace detail {
-        class sha224_256_base {
-        protected:
-            sha224_256_base(const std::array<std::uint32_t, 8>& init_state) noexcept : h_(init_state) {}
+        HASHLIB_CXX17_INLINE constexpr std::uint32_t sha256_round_constants[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+            0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
 
-        public:
-            auto update(span<const byte> bytes) noexcept -> void {
-                update(bytes.begin(), bytes.end());
+#if HASHLIB_HAS_SHANI
+        // compresses `count` blocks into `state` with the sha extensions, four rounds per step. the state is kept as
+        // the `abef` and `cdgh` halves `sha256rnds2` expects, and every step computes the next four words of the
+        // schedule from the last sixteen.
+        inline auto sha256_shani_compress(std::uint32_t* state, const byte* blocks, std::size_t count) noexcept -> void {
+#if defined(__AVX__)
+            // the sha instructions have no vex encoding, mixing them with dirty upper halves of the ymm registers
+            // costs a state transition per instruction.
+            _mm256_zeroupper();
+#endif
+            const auto mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+            auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+            auto hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+            auto abef = _mm_alignr_epi8(dcba, hgfe, 8);
+            auto cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+            for (; count > 0; --count, blocks += 64) {
+                const auto abef_save = abef;
+                const auto cdgh_save = cdgh;
+                __m128i msg[4];
+                for (std::size_t i = 0; i < 16; ++i) {
+                    if (i < 4) {
+                        msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * 16)), mask);
+                    }
+                    else {
+                        const auto w7 = _mm_alignr_epi8(msg[(i + 3) % 4], msg[(i + 2) % 4], 4);
+                        const auto w16 = _mm_sha256msg1_epu32(msg[i % 4], msg[(i + 1) % 4]);
+                        msg[i % 4] = _mm_sha256msg2_epu32(_mm_add_epi32(w16, w7), msg[(i + 3) % 4]);
+                    }
+                    const auto k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sha256_round_constants + i * 4));
+                    const auto wk = _mm_add_epi32(msg[i % 4], k);
+                    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+                    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+                }
+                abef = _mm_add_epi32(abef, abef_save);
+                cdgh = _mm_add_epi32(cdgh, cdgh_save);
             }
 
-            template<typename InputIt, typename Sentinel, enable_if_t<
-                is_input_iterator<InputIt>::value &&
-                !is_random_access_iterator<InputIt>::value &&
-                is_sentinel_for<Sentinel, InputIt>::value &&
-                is_byte_like<iter_value_t<InputIt>>::value
-            >* = nullptr>
-            auto update(InputIt first, Sentinel last) -> void {
-                byte temp[128];
-                for (auto it = first; it != last;) {
-                    std::size_t n = 0;
-                    for (; it != last && n < sizeof(temp); ++it, ++n) {
-                        temp[n] = static_cast<byte>(*it);
-                    }
-                    update({temp, n});
+            const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+            const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+        }
+#endif
+
+        // the compression function of `basic_sha224_256_base<Kernel>`. `compress(state, blocks, count)` compresses
+        // `count` blocks and `compress_constant<Padding>(state)` the constant last block of a message of fixed size.
+        template<typename Kernel>
+        struct sha256_kernel;
+
+        template<>
+        struct sha256_kernel<kernel::portable> {
+            static auto compress(std::array<std::uint32_t, 8>& state, const byte* blocks, std::size_t count) noexcept -> void {
+                for (std::size_t i = 0; i < count; ++i) {
+                    process(state, w_table(blocks + i * 64));
+                }
+            }
+
+            // the schedule of the constant block is computed once.
+            template<typename Padding>
+            static auto compress_constant(std::array<std::uint32_t, 8>& state) noexcept -> void {
+                static const auto w = w_table(Padding::constant_block().data());
+                process(state, w);
+            }
+
+            static auto process(std::array<std::uint32_t, 8>& state, const std::array<std::uint32_t, 64>& w) noexcept -> void {
+                auto a = state[0], b = state[1], c = state[2], d = state[3],
+                     e = state[4], f = state[5], g = state[6], h = state[7];
+
+                for (std::size_t i = 0; i < 64; ++i) {
+                    const auto S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+                    const auto ch = (e & f) ^ ((~e) & g);
+                    const auto temp1 = h + S1 + ch + sha256_round_constants[i] + w[i];
+                    const auto S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+                    const auto maj = (a & b) ^ (a & c) ^ (b & c);
+                    const auto temp2 = S0 + maj;
+
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + temp1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = temp1 + temp2;
                 }
+
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+                state[4] += e;
+                state[5] += f;
+                state[6] += g;
+                state[7] += h;
             }
 
-            template<typename RandomAccessIt, typename Sentinel, enable_if_t<
-                is_random_access_iterator<RandomAccessIt>::value &&
-                is_sentinel_for<Sentinel, RandomAccessIt>::value &&
-                is_byte_like<iter_value_t<RandomAccessIt>>::value
-            >* = nullptr>
-            auto update(RandomAccessIt first, Sentinel last) -> void {
-                std::size_t bytes_count = last - first;
+            static auto w_table(const byte* block) noexcept -> std::array<std::uint32_t, 64> {
+                std::array<std::uint32_t, 64> w; // NOLINT(*-pro-type-member-init)
+                for (std::size_t i = 0; i < 16; ++i) {
+                    w[i] = load_be32(block + i * 4);
+                }
+                for (std::size_t i = 16; i < 64; ++i) {
+                    const auto s0 = rotr32(w[i-15], 7) ^ rotr32(w[i-15], 18) ^ (w[i-15] >> 3);
+                    const auto s1 = rotr32(w[i-2], 17) ^ rotr32(w[i-2], 19) ^ (w[i-2] >> 10);
+                    w[i] = w[i-16] + s0 + w[i-7] + s1;
+                }
+                return w;
+            }
+
+            HASHLIB_ALWAYS_INLINE
+            static constexpr auto rotr32(std::uint32_t x, int n) noexcept -> std::uint32_t {
+                return (x >> n) | (x << (32 - n));
+            }
+        };
+
+#if HASHLIB_HAS_SHANI
+        template<>
+        struct sha256_kernel<kernel::shani> {
+            static auto compress(std::array<std::uint32_t, 8>& state, const byte* blocks, std::size_t count) noexcept -> void {
+                sha256_shani_compress(state.data(), blocks, count);
+            }
+
+            template<typename Padding>
+            static auto compress_constant(std::array<std::uint32_t, 8>& state) noexcept -> void {
+                static const auto block = Padding::constant_block();
+                sha256_shani_compress(state.data(), block.data(), 1);
+            }
+        };
+#endif
+
+        template<typename Kernel>
+        class basic_sha224_256_base {
+        public:
+            static constexpr std::size_t block_size = 64;
+            using state_type = std::array<std::uint32_t, 8>;
+
+        protected:
+            basic_sha224_256_base(const std::array<std::uint32_t, 8>& init_state) noexcept : h_(init_state) {}
+
+        public:
+            auto update(span<const byte> bytes) noexcept -> void {
+                std::size_t bytes_count = bytes.size();
                 total_size_ += bytes_count;
                 std::size_t i = 0;
 
                 if (buffer_size_ > 0) {
                     std::size_t to_copy = std::min(bytes_count, 64 - buffer_size_);
-                    std::copy_n(first, to_copy, buffer_.data() + buffer_size_);
+                    std::copy_n(bytes.data(), to_copy, buffer_.data() + buffer_size_);
                     buffer_size_ += to_copy;
                     i += to_copy;
                     if (buffer_size_ == 64) {
-                        process_(w_table_(buffer_.data()));
+                        sha256_kernel<Kernel>::compress(h_, buffer_.data(), 1);
                         buffer_size_ = 0;
                     }
                 }
 
-                for (; i + 63 < bytes_count; i += 64) {
-                    (process_)((w_table_)(std::next(first, i)));
+                if (bytes_count - i >= 64) {
+                    auto blocks = (bytes_count - i) / 64;
+                    sha256_kernel<Kernel>::compress(h_, bytes.data() + i, blocks);
+                    i += blocks * 64;
                 }
 
                 if (i < bytes_count) {
-                    std::copy_n(std::next(first, i), bytes_count - i, buffer_.data());
+                    std::copy_n(bytes.data() + i, bytes_count - i, buffer_.data());
                     buffer_size_ = bytes_count - i;
                 }
             }
 
         protected:
             auto do_digest() noexcept -> std::array<std::uint32_t, 8> {
-                auto_restorer<sha224_256_base> _{*this};
+                auto_restorer<basic_sha224_256_base> _{*this};
                 auto buffer_size = buffer_size_;
                 auto total_size = total_size_;
                 byte padding[128]{};
@@ -80,90 +241,48 @@ namespace hashlib {
                 return h_;
             }
 
-            HASHLIB_ALWAYS_INLINE
-            static auto unit_to_bytes(std::uint32_t unit) noexcept -> std::array<byte, 4> {
-                byte* byte_ptr = reinterpret_cast<byte*>(&unit);
-                if HASHLIB_CXX17_CONSTEXPR (is_little_endian()) {
-                    return {byte_ptr[3], byte_ptr[2], byte_ptr[1], byte_ptr[0]};
+            template<std::size_t N>
+            auto do_hash_fixed(const byte* data) noexcept -> std::array<std::uint32_t, 8> {
+                using padding = fixed_padding<N, 64, 8, true>;
+                sha256_kernel<Kernel>::compress(h_, data, padding::full_blocks);
+                if (padding::has_tail_block) {
+                    sha256_kernel<Kernel>::compress(h_, padding::tail_block(data + padding::full_blocks * 64).data(), 1);
                 }
-                else {
-                    return {byte_ptr[0], byte_ptr[1], byte_ptr[2], byte_ptr[3]};
+                if (padding::has_constant_block) {
+                    sha256_kernel<Kernel>::template compress_constant<padding>(h_);
                 }
+                return h_;
             }
 
-        private:
-            auto process_(const std::array<std::uint32_t, 64>& w) noexcept -> void {
-                static constexpr std::uint32_t k[64] = {
-                    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-                    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-                    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-                    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-                    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-                    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-                    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-                    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-                    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-                    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-                    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-                    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-                    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-                    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-                    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-                    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-                };
-
-                auto a = h_[0], b = h_[1], c = h_[2], d = h_[3],
-                     e = h_[4], f = h_[5], g = h_[6], h = h_[7];
-
-                for (std::size_t i = 0; i < 64; ++i) {
-                    const auto S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
-                    const auto ch = (e & f) ^ ((~e) & g);
-                    const auto temp1 = h + S1 + ch + k[i] + w[i];
-                    const auto S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
-                    const auto maj = (a & b) ^ (a & c) ^ (b & c);
-                    const auto temp2 = S0 + maj;
+            auto do_midstate() const noexcept -> basic_midstate<state_type> {
+                return {h_, total_size_ - buffer_size_};
+            }
 
-                    h = g;
-                    g = f;
-                    f = e;
-                    e = d + temp1;
-                    d = c;
-                    c = b;
-                    b = a;
-                    a = temp1 + temp2;
-                }
+            auto do_load_midstate(const basic_midstate<state_type>& midstate) noexcept -> bool {
+                if (midstate.size % block_size != 0) return false;
+                h_ = midstate.state;
+                total_size_ = midstate.size;
+                buffer_size_ = 0;
+                return true;
+            }
 
-                h_[0] += a;
-                h_[1] += b;
-                h_[2] += c;
-                h_[3] += d;
-                h_[4] += e;
-                h_[5] += f;
-                h_[6] += g;
-                h_[7] += h;
+            auto do_buffered() const noexcept -> span<const byte> {
+                return {buffer_.data(), buffer_size_};
             }
 
-            template<typename RandomAccessIt>
-            static auto w_table_(RandomAccessIt it) noexcept -> std::array<std::uint32_t, 64> {
-                static_assert(is_random_access_iterator<RandomAccessIt>::value, "unexpected");
-                std::array<std::uint32_t, 64> w; // NOLINT(*-pro-type-member-init)
-                for (std::size_t i = 0; i < 16; ++i) {
-                    w[i] = (std::uint32_t(it[i * 4]) << 24) |
-                           (std::uint32_t(it[i * 4 + 1]) << 16) |
-                           (std::uint32_t(it[i * 4 + 2]) << 8) |
-                           (std::uint32_t(it[i * 4 + 3]));
-                }
-                for (std::size_t i = 16; i < 64; ++i) {
-                    const auto s0 = rotr32(w[i-15], 7) ^ rotr32(w[i-15], 18) ^ (w[i-15] >> 3);
-                    const auto s1 = rotr32(w[i-2], 17) ^ rotr32(w[i-2], 19) ^ (w[i-2] >> 10);
-                    w[i] = w[i-16] + s0 + w[i-7] + s1;
-                }
-                return w;
+            auto do_partial_block() noexcept -> partial_block {
+                return {buffer_.data(), buffer_size_, total_size_};
             }
 
             HASHLIB_ALWAYS_INLINE
-            static constexpr auto rotr32(std::uint32_t x, int n) noexcept -> std::uint32_t {
-                return (x >> n) | (x << (32 - n));
+            static auto unit_to_bytes(std::uint32_t unit) noexcept -> std::array<byte, 4> {
+                byte* byte_ptr = reinterpret_cast<byte*>(&unit);
+                if HASHLIB_CXX17_CONSTEXPR (is_little_endian()) {
+                    return {byte_ptr[3], byte_ptr[2], byte_ptr[1], byte_ptr[0]};
+                }
+                else {
+                    return {byte_ptr[0], byte_ptr[1], byte_ptr[2], byte_ptr[3]};
+                }
             }
 
         protected:
@@ -173,64 +292,56 @@ namespace hashlib {
             std::array<std::uint32_t, 8> h_;
         };
 
-        struct sha256 : sha224_256_base {
+        template<typename Kernel>
+        constexpr std::size_t basic_sha224_256_base<Kernel>::block_size;
+
+        template<typename Kernel>
+        struct basic_sha256 : basic_sha224_256_base<Kernel> {
             static constexpr std::size_t digest_size = 32;
 
-            sha256() noexcept : sha224_256_base({
+            basic_sha256() noexcept : basic_sha224_256_base<Kernel>({
                 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
                 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
             }) {}
 
         };
 
-        struct sha224 : sha224_256_base {
+        template<typename Kernel>
+        struct basic_sha224 : basic_sha224_256_base<Kernel> {
             static constexpr std::size_t digest_size = 28;
 
-            sha224() noexcept : sha224_256_base({
+            basic_sha224() noexcept : basic_sha224_256_base<Kernel>({
                 0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
                 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
             }) {}
         };
 
+        template<typename Kernel>
+        constexpr std::size_t basic_sha256<Kernel>::digest_size;
+
+        template<typename Kernel>
+        constexpr std::size_t basic_sha224<Kernel>::digest_size;
+
+        using sha256 = basic_sha256<kernel::portable>;
+        using sha224 = basic_sha224<kernel::portable>;
+
         class sha384_512_base {
+        public:
+            static constexpr std::size_t block_size = 128;
+            using state_type = std::array<std::uint64_t, 8>;
+
         protected:
             sha384_512_base(const std::array<std::uint64_t, 8>& init_state) noexcept : h_(init_state) {}
 
         public:
             auto update(span<const byte> bytes) noexcept -> void {
-                update(bytes.begin(), bytes.end());
-            }
-
-            template<typename InputIt, typename Sentinel, enable_if_t<
-                is_input_iterator<InputIt>::value &&
-                !is_random_access_iterator<InputIt>::value &&
-                is_sentinel_for<Sentinel, InputIt>::value &&
-                is_byte_like<iter_value_t<InputIt>>::value
-            >* = nullptr>
-            auto update(InputIt first, Sentinel last) -> void {
-                byte temp[256];
-                for (auto it = first; it != last;) {
-                    std::size_t n = 0;
-                    for (; it != last && n < sizeof(temp); ++it, ++n) {
-                        temp[n] = static_cast<byte>(*it);
-                    }
-                    update({temp, n});
-                }
-            }
-
-            template<typename RandomAccessIt, typename Sentinel, enable_if_t<
-                is_random_access_iterator<RandomAccessIt>::value &&
-                is_sentinel_for<Sentinel, RandomAccessIt>::value &&
-                is_byte_like<iter_value_t<RandomAccessIt>>::value
-            >* = nullptr>
-            auto update(RandomAccessIt first, Sentinel last) -> void {
-                std::size_t bytes_count = last - first;
+                std::size_t bytes_count = bytes.size();
                 total_size_ += bytes_count;
                 std::size_t i = 0;
 
                 if (buffer_size_ > 0) {
                     std::size_t to_copy = std::min(bytes_count, 128 - buffer_size_);
-                    std::copy_n(first, to_copy, buffer_.data() + buffer_size_);
+                    std::copy_n(bytes.data(), to_copy, buffer_.data() + buffer_size_);
                     buffer_size_ += to_copy;
                     i += to_copy;
                     if (buffer_size_ == 128) {
@@ -240,11 +351,11 @@ namespace hashlib {
                 }
 
                 for (; i + 127 < bytes_count; i += 128) {
-                    (process_)((w_table_)(std::next(first, i)));
+                    process_(w_table_(bytes.data() + i));
                 }
 
                 if (i < bytes_count) {
-                    std::copy_n(std::next(first, i), bytes_count - i, buffer_.data());
+                    std::copy_n(bytes.data() + i, bytes_count - i, buffer_.data());
                     buffer_size_ = bytes_count - i;
                 }
             }
@@ -273,6 +384,42 @@ namespace hashlib {
                 return h_;
             }
 
+            template<std::size_t N>
+            auto do_hash_fixed(const byte* data) noexcept -> std::array<std::uint64_t, 8> {
+                using padding = fixed_padding<N, 128, 16, true>;
+                for (std::size_t i = 0; i < padding::full_blocks; ++i) {
+                    process_(w_table_(data + i * 128));
+                }
+                if (padding::has_tail_block) {
+                    process_(w_table_(padding::tail_block(data + padding::full_blocks * 128).data()));
+                }
+                if (padding::has_constant_block) {
+                    static const auto w = w_table_(padding::constant_block().data());
+                    process_(w);
+                }
+                return h_;
+            }
+
+            auto do_midstate() const noexcept -> basic_midstate<state_type> {
+                return {h_, total_size_ - buffer_size_};
+            }
+
+            auto do_load_midstate(const basic_midstate<state_type>& midstate) noexcept -> bool {
+                if (midstate.size % block_size != 0) return false;
+                h_ = midstate.state;
+                total_size_ = midstate.size;
+                buffer_size_ = 0;
+                return true;
+            }
+
+            auto do_buffered() const noexcept -> span<const byte> {
+                return {buffer_.data(), buffer_size_};
+            }
+
+            auto do_partial_block() noexcept -> partial_block {
+                return {buffer_.data(), buffer_size_, total_size_};
+            }
+
             HASHLIB_ALWAYS_INLINE
             static auto unit_to_bytes(std::uint64_t unit) noexcept -> std::array<byte, 8> {
                 byte* byte_ptr = reinterpret_cast<byte*>(&unit);
@@ -346,19 +493,10 @@ namespace hashlib {
                 h_[7] += h;
             }
 
-            template<typename RandomAccessIt>
-            static auto w_table_(RandomAccessIt it) noexcept -> std::array<std::uint64_t, 80> {
-                static_assert(is_random_access_iterator<RandomAccessIt>::value, "unexpected");
+            static auto w_table_(const byte* block) noexcept -> std::array<std::uint64_t, 80> {
                 std::array<std::uint64_t, 80> w; // NOLINT(*-pro-type-member-init)
                 for (std::size_t i = 0; i < 16; ++i) {
-                    w[i] = (std::uint64_t(it[i * 8]) << 56) |
-                           (std::uint64_t(it[i * 8 + 1]) << 48) |
-                           (std::uint64_t(it[i * 8 + 2]) << 40) |
-                           (std::uint64_t(it[i * 8 + 3]) << 32) |
-                           (std::uint64_t(it[i * 8 + 4]) << 24) |
-                           (std::uint64_t(it[i * 8 + 5]) << 16) |
-                           (std::uint64_t(it[i * 8 + 6]) << 8) |
-                           (std::uint64_t(it[i * 8 + 7]));
+                    w[i] = load_be64(block + i * 8);
                 }
                 for (std::size_t i = 16; i < 80; ++i) {
                     const auto s0 = rotr64(w[i-15], 1) ^ rotr64(w[i-15], 8) ^ (w[i-15] >> 7);
@@ -401,10 +539,104 @@ namespace hashlib {
                 0xdb0c2e0d64f98fa7ull, 0x47b5481dbefa4fa4ull
             }) {}
         };
+
+        // compresses one block of each of `lanes` independent sha-256 streams at once. the states and the message
+        // schedules are stored word by word across the lanes, so every step of a round is the same operation over all
+        // the lanes, which the compiler turns into vector instructions.
+        struct sha256_lanes {
+            static constexpr std::size_t lanes = 8;
+            using word_type = std::uint32_t;
+            static constexpr std::size_t max_padding_blocks = 2;
+
+            // word `j` of lane `l` is `state[j * lanes + l]`.
+            static auto compress(std::uint32_t* state, const byte* const* blocks) noexcept -> void {
+                std::uint32_t w[64][lanes];
+                for (std::size_t i = 0; i < 16; ++i) {
+                    for (std::size_t l = 0; l < lanes; ++l) {
+                        w[i][l] = load_be32(blocks[l] + i * 4);
+                    }
+                }
+                for (std::size_t i = 16; i < 64; ++i) {
+                    for (std::size_t l = 0; l < lanes; ++l) {
+                        const auto s0 = rotr32_(w[i-15][l], 7) ^ rotr32_(w[i-15][l], 18) ^ (w[i-15][l] >> 3);
+                        const auto s1 = rotr32_(w[i-2][l], 17) ^ rotr32_(w[i-2][l], 19) ^ (w[i-2][l] >> 10);
+                        w[i][l] = w[i-16][l] + s0 + w[i-7][l] + s1;
+                    }
+                }
+
+                std::uint32_t v[8][lanes];
+                std::copy_n(state, 8 * lanes, &v[0][0]);
+                for (std::size_t i = 0; i < 64; ++i) {
+                    for (std::size_t l = 0; l < lanes; ++l) {
+                        const auto a = v[0][l], b = v[1][l], c = v[2][l], d = v[3][l],
+                                   e = v[4][l], f = v[5][l], g = v[6][l], h = v[7][l];
+                        const auto S1 = rotr32_(e, 6) ^ rotr32_(e, 11) ^ rotr32_(e, 25);
+                        const auto ch = (e & f) ^ ((~e) & g);
+                        const auto temp1 = h + S1 + ch + sha256_round_constants[i] + w[i][l];
+                        const auto S0 = rotr32_(a, 2) ^ rotr32_(a, 13) ^ rotr32_(a, 22);
+                        const auto maj = (a & b) ^ (a & c) ^ (b & c);
+
+                        v[7][l] = g;
+                        v[6][l] = f;
+                        v[5][l] = e;
+                        v[4][l] = d + temp1;
+                        v[3][l] = c;
+                        v[2][l] = b;
+                        v[1][l] = a;
+                        v[0][l] = temp1 + S0 + maj;
+                    }
+                }
+                for (std::size_t j = 0; j < 8; ++j) {
+                    for (std::size_t l = 0; l < lanes; ++l) {
+                        state[j * lanes + l] += v[j][l];
+                    }
+                }
+            }
+
+            // the padding of a message of `size` bytes is `0x80`, zeros and its length in bits as 64 bits big endian.
+            // writes the last blocks of the message, whose partial block is `tail`, and returns how many there are.
+            static auto pad(const byte* tail, std::size_t tail_size, std::uint64_t size, byte* blocks) noexcept -> std::size_t {
+                const std::size_t count = tail_size < 56 ? 1 : 2;
+                std::fill_n(blocks, count * 64, byte(0));
+                std::copy_n(tail, tail_size, blocks);
+                blocks[tail_size] = 0x80;
+                for (std::size_t i = 0; i < 8; ++i) {
+                    blocks[count * 64 - 1 - i] = static_cast<byte>((size * 8) >> (8 * i));
+                }
+                return count;
+            }
+
+            // the digest is the state big endian.
+            static auto store_word(std::uint32_t word, byte* out) noexcept -> void {
+                for (std::size_t i = 0; i < 4; ++i) out[i] = static_cast<byte>(word >> (8 * (3 - i)));
+            }
+
+        private:
+            HASHLIB_ALWAYS_INLINE
+            static constexpr auto rotr32_(std::uint32_t x, int n) noexcept -> std::uint32_t {
+                return (x >> n) | (x << (32 - n));
+            }
+        };
+
+        template<typename Kernel>
+        struct lane_kernel<context<basic_sha224<Kernel>>> {
+            using type = sha256_lanes;
+        };
+
+        template<typename Kernel>
+        struct lane_kernel<context<basic_sha256<Kernel>>> {
+            using type = sha256_lanes;
+        };
     }
 
-    HASHLIB_MOD_EXPORT using sha224 = context<detail::sha224>;
-    HASHLIB_MOD_EXPORT using sha256 = context<detail::sha256>;
+    // sha224 and sha256 with the compression function `Kernel`, e.g. `hashlib::sha256_t<hashlib::kernel::native>`.
+    HASHLIB_MOD_EXPORT template<typename Kernel>
+    using sha224_t = context<detail::basic_sha224<Kernel>>;
+    HASHLIB_MOD_EXPORT template<typename Kernel>
+    using sha256_t = context<detail::basic_sha256<Kernel>>;
+
+    HASHLIB_MOD_EXPORT using sha224 = sha224_t<kernel::portable>;
+    HASHLIB_MOD_EXPORT using sha256 = sha256_t<kernel::portable>;
     HASHLIB_MOD_EXPORT using sha384 = context<detail::sha384>;
     HASHLIB_MOD_EXPORT using sha512 = context<detail::sha512>;
 }
\ No newline at end of file
@@ -14,85 +14,97 @@ namespace hashlib {
             );
         public:
             static constexpr std::size_t digest_size = Bits / 8;
+            static constexpr std::size_t block_size = (1600 - Bits * 2) / 8;
+            using state_type = std::array<std::uint64_t, 25>;
 
         public:
             sha3() = default;
 
+            // the bytes are xored into the state as they arrive, so there is no buffer for the partial block.
             auto update(span<const byte> bytes) noexcept -> void {
-                update(bytes.begin(), bytes.end());
-            }
-
-            template<typename InputIt, typename Sentinel, enable_if_t<
-                is_input_iterator<InputIt>::value &&
-                !is_random_access_iterator<InputIt>::value &&
-                is_sentinel_for<Sentinel, InputIt>::value &&
-                is_byte_like<iter_value_t<InputIt>>::value
-            >* = nullptr>
-            auto update(InputIt first, Sentinel last) -> void {
-                byte temp[256];
-                for (auto it = first; it != last;) {
-                    std::size_t n = 0;
-                    for (; it != last && n < sizeof(temp); ++it, ++n) {
-                        temp[n] = static_cast<byte>(*it);
-                    }
-                    this->update({temp, n});
+                auto data = bytes.data();
+                auto bytes_count = bytes.size();
+                auto position = static_cast<std::size_t>(size_ % block_size);
+                size_ += bytes_count;
+
+                // up to the next word, the block size is a multiple of the word size
+                for (; bytes_count > 0 && position % 8 != 0; --bytes_count, ++position) {
+                    absorb_byte_(position, *data++);
                 }
-            }
-
-            template<typename RandomAccessIt, typename Sentinel, enable_if_t<
-                is_random_access_iterator<RandomAccessIt>::value &&
-                is_sentinel_for<Sentinel, RandomAccessIt>::value &&
-                is_byte_like<iter_value_t<RandomAccessIt>>::value
-            >* = nullptr>
-            auto update(RandomAccessIt first, Sentinel last) -> void {
-                std::size_t bytes_count = last - first;
-                std::size_t i = 0;
-
-                if (buffer_size_ > 0) {
-                    std::size_t to_copy = std::min(bytes_count, block_size - buffer_size_);
-                    std::copy_n(first, to_copy, buffer_.begin() + buffer_size_);
-                    buffer_size_ += to_copy;
-                    i += to_copy;
-
-                    if (buffer_size_ == block_size) {
-                        absorb_block_();
-                        buffer_size_ = 0;
-                    }
+                if (position == block_size) {
+                    keccak_f_();
+                    position = 0;
                 }
 
-                for (; i + block_size <= bytes_count; i += block_size) {
-                    std::copy_n(first + i, block_size, buffer_.begin());
-                    absorb_block_();
+                while (bytes_count >= 8) {
+                    if (position == 0 && bytes_count >= block_size) {
+                        absorb_block_(data);
+                        data += block_size;
+                        bytes_count -= block_size;
+                        continue;
+                    }
+                    state_[position / 8] ^= load_le64(data);
+                    data += 8;
+                    bytes_count -= 8;
+                    position += 8;
+                    if (position == block_size) {
+                        keccak_f_();
+                        position = 0;
+                    }
                 }
 
-                if (i < bytes_count) {
-                    std::copy_n(first + i, bytes_count - i, buffer_.begin());
-                    buffer_size_ = bytes_count - i;
+                for (; bytes_count > 0; --bytes_count, ++position) {
+                    absorb_byte_(position, *data++);
                 }
             }
 
             auto do_digest() noexcept -> std::array<byte, digest_size> {
                 auto_restorer<sha3> _{*this};
-                byte padding[block_size]{};
-                if (buffer_size_ == block_size - 1) {
-                    padding[0] = 0x86;  // 0x06 | 0x80
-                    this->update({padding, 1});
+                absorb_byte_(static_cast<std::size_t>(size_ % block_size), 0x06);
+                absorb_byte_(block_size - 1, 0x80);
+                keccak_f_();
+                return this->squeeze_();
+            }
+
+            template<std::size_t N>
+            auto do_hash_fixed(const byte* data) noexcept -> std::array<byte, digest_size> {
+                for (std::size_t i = 0; i < N / block_size; ++i) {
+                    absorb_block_(data + i * block_size);
+                }
+                std::array<byte, block_size> last{};
+                std::copy_n(data + N / block_size * block_size, N % block_size, last.data());
+                last[N % block_size] ^= 0x06;
+                last[block_size - 1] ^= 0x80;
+                absorb_block_(last.data());
+                return this->squeeze_();
+            }
+
+            // the partial block is part of the state, so the midstate is complete after any number of bytes.
+            auto do_midstate() const noexcept -> basic_midstate<state_type> {
+                return {state_, size_};
+            }
+
+            auto do_load_midstate(const basic_midstate<state_type>& midstate) noexcept -> bool {
+                state_ = midstate.state;
+                size_ = midstate.size;
+                return true;
+            }
+
+            auto do_buffered() const noexcept -> span<const byte> {
+                return {};
+            }
+
+            // a short write is xored into the state and goes through `update` only when it completes the block.
+            HASHLIB_ALWAYS_INLINE
+            auto do_put(const byte* data, std::size_t n) noexcept -> void {
+                auto position = static_cast<std::size_t>(size_ % block_size);
+                if (n < block_size - position) {
+                    size_ += n;
+                    for (std::size_t i = 0; i < n; ++i) absorb_byte_(position + i, data[i]);
                 }
                 else {
-                    padding[0] = 0x06;
-                    if (buffer_size_ == 0) {
-                        padding[0] = 0x06;
-                        padding[block_size - 1] = 0x80;
-                        this->update({padding, block_size});
-                    }
-                    else {
-                        std::size_t padding_size = block_size - buffer_size_;
-                        padding[padding_size - 1] = 0x80;
-                        this->update({padding, padding_size});
-                    }
+                    update({data, n});
                 }
-
-                return this->squeeze_();
             }
 
             HASHLIB_ALWAYS_INLINE static auto unit_to_bytes(byte unit) noexcept -> std::array<byte, 1> {
@@ -100,18 +112,19 @@ namespace hashlib {
             }
 
         private:
-            auto absorb_block_() noexcept -> void {
+            auto absorb_block_(const byte* block) noexcept -> void {
                 for (std::size_t i = 0; i < block_size / 8; ++i) {
-                    std::uint64_t word = 0;
-                    for (std::size_t j = 0; j < 8; ++j) {
-                        word |= std::uint64_t(buffer_[i * 8 + j]) << (8 * j);
-                    }
-                    state_[i] ^= word;
+                    state_[i] ^= load_le64(block + i * 8);
                 }
 
                 keccak_f_();
             }
 
+            HASHLIB_ALWAYS_INLINE
+            auto absorb_byte_(std::size_t position, byte value) noexcept -> void {
+                state_[position / 8] ^= static_cast<std::uint64_t>(value) << (8 * (position % 8));
+            }
+
             auto keccak_f_() noexcept -> void {
                 static constexpr std::uint64_t RC[24]{
                     0x0000000000000001, 0x0000000000008082, 0x800000000000808a,
@@ -195,11 +208,9 @@ namespace hashlib {
             }
 
         private:
-            static constexpr std::size_t rate_size = 1600 - Bits * 2;
-            static constexpr std::size_t block_size = rate_size / 8;
-            std::array<std::uint64_t, 25> state_{};
-            std::array<byte, block_size> buffer_{};
-            std::size_t buffer_size_ = 0;
+            state_type state_{};
+            // the number of bytes hashed, the position in the current block is `size_ % block_size`.
+            std::uint64_t size_ = 0;
         };
     }
 
@@ -0,0 +1,144 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include <ostream>
+#endif
+
+namespace hashlib {
+    namespace detail {
+        // the characters are hashed, and forwarded to the tee, once this many have been written.
+        HASHLIB_CXX17_INLINE constexpr std::size_t hashing_streambuf_size = 65536;
+    }
+
+    // a streambuf which hashes everything written to it, e.g. to get the digest of an archive while it is written.
+    // it either swallows the characters or forwards them to another streambuf, the tee, only the characters accepted
+    // by the tee are hashed. writes smaller than the internal buffer are collected in it, larger writes are hashed
+    // and forwarded without a copy.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename CharT = char, typename Traits = std::char_traits<CharT>>
+    class basic_hashing_streambuf : public std::basic_streambuf<CharT, Traits> {
+        static_assert(detail::is_byte_like<CharT>::value, "unexpected");
+    public:
+        using int_type = typename Traits::int_type;
+
+    public:
+        basic_hashing_streambuf() : basic_hashing_streambuf(nullptr) {}
+
+        explicit basic_hashing_streambuf(std::basic_streambuf<CharT, Traits>* tee)
+            : tee_(tee), buffer_(detail::hashing_streambuf_size) {
+            this->setp(buffer_.data(), buffer_.data() + buffer_.size());
+        }
+
+        basic_hashing_streambuf(const basic_hashing_streambuf&) = delete;
+
+        // the rest of the buffer goes to the tee. an exception of the tee is swallowed, as std::basic_filebuf does.
+        ~basic_hashing_streambuf() override {
+            try {
+                flush_();
+            } catch (...) {
+            }
+        }
+
+        auto operator= (const basic_hashing_streambuf&) -> basic_hashing_streambuf& = delete;
+
+        // the digest of the characters written so far, writing may continue afterwards.
+        HASHLIB_NODISCARD auto digest() -> std::array<byte, Algo::digest_size> {
+            flush_();
+            return ctx_.digest();
+        }
+
+        HASHLIB_NODISCARD auto hexdigest() -> std::string {
+            flush_();
+            return ctx_.hexdigest();
+        }
+
+        HASHLIB_NODISCARD auto tee() const noexcept -> std::basic_streambuf<CharT, Traits>* {
+            return tee_;
+        }
+
+    protected:
+        auto overflow(int_type ch) -> int_type override {
+            if (!flush_()) return Traits::eof();
+            if (!Traits::eq_int_type(ch, Traits::eof())) {
+                *this->pptr() = Traits::to_char_type(ch);
+                this->pbump(1);
+            }
+            return Traits::not_eof(ch);
+        }
+
+        auto xsputn(const CharT* s, std::streamsize count) -> std::streamsize override {
+            if (count <= this->epptr() - this->pptr()) {
+                std::copy_n(s, count, this->pptr());
+                this->pbump(static_cast<int>(count));
+                return count;
+            }
+            if (!flush_()) return 0;
+            if (count < static_cast<std::streamsize>(buffer_.size())) {
+                std::copy_n(s, count, this->pptr());
+                this->pbump(static_cast<int>(count));
+                return count;
+            }
+            return write_(s, count);
+        }
+
+        auto sync() -> int override {
+            if (!flush_()) return -1;
+            return tee_ != nullptr ? tee_->pubsync() : 0;
+        }
+
+    private:
+        // hashes the characters accepted by the tee, all of them when there is none.
+        auto write_(const CharT* s, std::streamsize count) -> std::streamsize {
+            auto written = tee_ != nullptr ? tee_->sputn(s, count) : count;
+            ctx_.update({reinterpret_cast<const byte*>(s), static_cast<std::size_t>(written)});
+            return written;
+        }
+
+        auto flush_() -> bool {
+            auto count = this->pptr() - this->pbase();
+            auto written = write_(this->pbase(), count);
+            this->setp(buffer_.data(), buffer_.data() + buffer_.size());
+            return written == count;
+        }
+
+    private:
+        Algo ctx_;
+        std::basic_streambuf<CharT, Traits>* tee_;
+        std::vector<CharT> buffer_;
+    };
+
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    using hashing_streambuf = basic_hashing_streambuf<Algo, char>;
+
+    // an ostream over a `basic_hashing_streambuf`, e.g. `hashlib::hashing_ostream<sha256> os; os << value;`.
+    HASHLIB_MOD_EXPORT template<typename Algo, typename CharT = char, typename Traits = std::char_traits<CharT>>
+    class basic_hashing_ostream : public std::basic_ostream<CharT, Traits> {
+    public:
+        basic_hashing_ostream() : std::basic_ostream<CharT, Traits>(nullptr) {
+            std::basic_ios<CharT, Traits>::rdbuf(&buf_);
+        }
+
+        // writes through to the streambuf of `tee` as well.
+        explicit basic_hashing_ostream(std::basic_ostream<CharT, Traits>& tee)
+            : std::basic_ostream<CharT, Traits>(nullptr), buf_(tee.rdbuf()) {
+            std::basic_ios<CharT, Traits>::rdbuf(&buf_);
+        }
+
+        HASHLIB_NODISCARD auto digest() -> std::array<byte, Algo::digest_size> {
+            return buf_.digest();
+        }
+
+        HASHLIB_NODISCARD auto hexdigest() -> std::string {
+            return buf_.hexdigest();
+        }
+
+        HASHLIB_NODISCARD auto rdbuf() const noexcept -> basic_hashing_streambuf<Algo, CharT, Traits>* {
+            return const_cast<basic_hashing_streambuf<Algo, CharT, Traits>*>(&buf_);
+        }
+
+    private:
+        basic_hashing_streambuf<Algo, CharT, Traits> buf_;
+    };
+
+    HASHLIB_MOD_EXPORT template<typename Algo>
+    using hashing_ostream = basic_hashing_ostream<Algo, char>;
+}
@@ -0,0 +1,124 @@
+#include <hashlib/af_alg.hpp>
+#include "common.h"
+
+TEST_CASE("testing af_alg_context") {
+    std::string content;
+    for (std::size_t i = 0; i < 300000; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+
+    SUBCASE("update") {
+        hashlib::af_alg_context<hashlib::sha256> ctx;
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{}.hexdigest());
+        ctx.update(content);
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{content}.hexdigest());
+
+        // digest does not finalize the context
+        auto copy = ctx;
+        ctx.update(content);
+        copy.update(std::string{"abc"});
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{content + content}.hexdigest());
+        CHECK_EQ(copy.hexdigest(), hashlib::sha256{content + "abc"}.hexdigest());
+
+        ctx.clear();
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{}.hexdigest());
+    }
+
+    SUBCASE("algorithms") {
+        CHECK_EQ(hashlib::af_alg_context<hashlib::md5>{}.hexdigest(), hashlib::md5{}.hexdigest());
+        CHECK_EQ(hashlib::af_alg_context<hashlib::sha1>{}.hexdigest(), hashlib::sha1{}.hexdigest());
+        CHECK_EQ(hashlib::af_alg_context<hashlib::sha512>{}.hexdigest(), hashlib::sha512{}.hexdigest());
+        CHECK_EQ(hashlib::af_alg_context<hashlib::sha3_256>{}.hexdigest(), hashlib::sha3_256{}.hexdigest());
+    }
+
+#if HASHLIB_PLATFORM_POSIX
+    SUBCASE("update from fd") {
+        const char* filename = "hashlib-test-af_alg.bin";
+        {
+            std::ofstream file{filename, std::ios::out | std::ios::binary};
+            REQUIRE(file.is_open());
+            file << content;
+        }
+        int fd = ::open(filename, O_RDONLY);
+        REQUIRE(fd >= 0);
+        hashlib::af_alg_context<hashlib::md5> ctx;
+        ctx.update_from_fd(fd, 1000, 200000);
+        CHECK_EQ(ctx.hexdigest(), hashlib::md5{content.substr(1000, 200000)}.hexdigest());
+        // the count is clamped at the end of the file
+        ctx.update_from_fd(fd, 250000, 100000);
+        CHECK_EQ(ctx.hexdigest(), hashlib::md5{content.substr(1000, 200000) + content.substr(250000)}.hexdigest());
+        ::close(fd);
+        std::remove(filename);
+    }
+#endif
+}
+
+// the cases above pass through whichever path is available, this one only runs the kernel path and skips otherwise.
+TEST_CASE("testing af_alg_context in the kernel") {
+    hashlib::af_alg_context<hashlib::sha256> ctx;
+    if (!ctx.uses_kernel()) {
+        MESSAGE("AF_ALG is unavailable, the kernel path is not tested");
+        return;
+    }
+
+    std::string content;
+    for (std::size_t i = 0; i < 300000; ++i) {
+        content.push_back(static_cast<char>(i * 7 + i / 13));
+    }
+
+    SUBCASE("send") {
+        hashlib::sha256 expected;
+        // writes of every size around the page and block boundaries
+        std::size_t offset = 0;
+        for (std::size_t n = 1; offset + n <= content.size(); n = n * 3 + 1) {
+            ctx.update(content.substr(offset, n));
+            expected.update(content.substr(offset, n));
+            offset += n;
+            CHECK_EQ(ctx.hexdigest(), expected.hexdigest());
+        }
+
+        // a copy is an `accept` of the operation socket, it continues independently
+        auto copy = ctx;
+        REQUIRE(copy.uses_kernel());
+        copy.update(std::string{"abc"});
+        auto expected_copy = expected;
+        expected_copy.update(std::string{"abc"});
+        CHECK_EQ(copy.hexdigest(), expected_copy.hexdigest());
+        CHECK_EQ(ctx.hexdigest(), expected.hexdigest());
+    }
+
+    SUBCASE("algorithms") {
+        hashlib::af_alg_context<hashlib::md5> md5;
+        hashlib::af_alg_context<hashlib::sha1> sha1;
+        hashlib::af_alg_context<hashlib::sha512> sha512;
+        hashlib::af_alg_context<hashlib::sha3_256> sha3_256;
+        md5.update(content);
+        sha1.update(content);
+        sha512.update(content);
+        sha3_256.update(content);
+        if (md5.uses_kernel()) CHECK_EQ(md5.hexdigest(), hashlib::md5{content}.hexdigest());
+        if (sha1.uses_kernel()) CHECK_EQ(sha1.hexdigest(), hashlib::sha1{content}.hexdigest());
+        if (sha512.uses_kernel()) CHECK_EQ(sha512.hexdigest(), hashlib::sha512{content}.hexdigest());
+        if (sha3_256.uses_kernel()) CHECK_EQ(sha3_256.hexdigest(), hashlib::sha3_256{content}.hexdigest());
+    }
+
+#if HASHLIB_PLATFORM_POSIX
+    SUBCASE("splice") {
+        const char* filename = "hashlib-test-af_alg-kernel.bin";
+        {
+            std::ofstream file{filename, std::ios::out | std::ios::binary};
+            REQUIRE(file.is_open());
+            file << content;
+        }
+        int fd = ::open(filename, O_RDONLY);
+        REQUIRE(fd >= 0);
+        // more than a pipe holds, from an unaligned offset, then a count clamped at the end of the file
+        ctx.update_from_fd(fd, 4097, 200000);
+        ctx.update(std::string{"xyz"});
+        ctx.update_from_fd(fd, 250000, 100000);
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{content.substr(4097, 200000) + "xyz" + content.substr(250000)}.hexdigest());
+        ::close(fd);
+        std::remove(filename);
+    }
+#endif
+}
@@ -0,0 +1,93 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/async.hpp>
+#include "common.h"
+
+#if HASHLIB_HAS_COROUTINES
+#include <deque>
+#include <functional>
+
+namespace {
+    // runs the submitted tasks when the test drains the queue.
+    struct queue_executor {
+        std::deque<std::function<void()>>* tasks;
+
+        auto execute(std::function<void()> f) const -> void {
+            tasks->push_back(std::move(f));
+        }
+    };
+
+    auto drain(std::deque<std::function<void()>>& tasks) -> std::size_t {
+        std::size_t count = 0;
+        while (!tasks.empty()) {
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            task();
+            ++count;
+        }
+        return count;
+    }
+
+    struct detached {
+        struct promise_type {
+            auto get_return_object() noexcept -> detached { return {}; }
+            auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+            auto final_suspend() noexcept -> std::suspend_never { return {}; }
+            auto return_void() noexcept -> void {}
+            auto unhandled_exception() -> void { throw; }
+        };
+    };
+
+    auto hash_to(std::string path, queue_executor executor, std::stop_token token, std::string& result, std::error_code& ec) -> detached {
+        try {
+            result = (co_await hashlib::async_hash_file<hashlib::md5>(path, executor, token)).hexdigest();
+        } catch (const std::system_error& e) {
+            ec = e.code();
+        }
+    }
+}
+
+TEST_CASE("testing async_hash_file") {
+    std::string content;
+    for (std::size_t i = 0; i < (std::size_t(3) << 20) + 12345; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+    const char* filename = "hashlib-test-async.bin";
+    {
+        std::ofstream file{filename, std::ios::out | std::ios::binary};
+        REQUIRE(file.is_open());
+        file << content;
+    }
+
+    std::deque<std::function<void()>> tasks;
+    std::string result;
+    std::error_code ec;
+
+    SUBCASE("chunks") {
+        hash_to(filename, {&tasks}, {}, result, ec);
+        CHECK(result.empty());
+        // one task per chunk plus the one that finds the end of the file
+        CHECK_EQ(drain(tasks), 5);
+        CHECK_FALSE(ec);
+        CHECK_EQ(result, hashlib::md5{content}.hexdigest());
+    }
+
+    SUBCASE("cancellation") {
+        std::stop_source source;
+        hash_to(filename, {&tasks}, source.get_token(), result, ec);
+        tasks.front()();
+        tasks.pop_front();
+        source.request_stop();
+        drain(tasks);
+        CHECK_EQ(ec, std::errc::operation_canceled);
+        CHECK(result.empty());
+    }
+
+    SUBCASE("missing file") {
+        hash_to(HASHLIB_TEST_DIR"/files/no-such-file", {&tasks}, {}, result, ec);
+        drain(tasks);
+        CHECK_EQ(ec, std::errc::no_such_file_or_directory);
+    }
+
+    std::remove(filename);
+}
+#endif
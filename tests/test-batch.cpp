@@ -0,0 +1,83 @@
+#include <map>
+#include <hashlib/sha2.hpp>
+#include <hashlib/batch.hpp>
+#include "common.h"
+
+TEST_CASE("testing hash_files_batch") {
+    std::string dir = HASHLIB_TEST_DIR"/files/sha256/";
+    std::vector<std::string> filenames{
+        "12e3d508453dba4ac11545a1a4f5d684058752f27b1a87c59b4dd270ce6f0c8e",
+        "193442bab43399feb8a9f755b67197563e69a4a5e24eb9d25a801e14199f4d93",
+        "551b4599583cac123c4b26e1fa9d1a2009bb2c8700aa925d917f18fb30cef0eb",
+        "6daf2e956ed820815f64d61bd78d35b162507009bf7e73e46767d58cb409df12",
+        "86c7242ddf4762df914d53adeb7fc9eeecd4ba0fbdbc98d38925b9d115512deb",
+        "931a305319903cfbbec6bcac57ec4b9a00893079e7a998caf44250cb949fab67",
+        "c61f9e7c137384497ed0864e649f13dbc82d2608b2c8b573aff13f7a857a4bd8",
+        "da1fe846db926bb2522bb8253cd6cf12608787737d54e055493c6389f9a81a67"
+    };
+    std::vector<std::string> paths;
+    for (const auto& filename : filenames) {
+        paths.push_back(dir + filename);
+    }
+    paths.push_back(dir + "no-such-file");
+    // procfs reports a size of 0 whatever the content, the content of this one does not change between two reads
+    const std::string proc_path = "/proc/version";
+    paths.push_back(proc_path);
+
+    hashlib::batch_options options;
+    SUBCASE("default options") {}
+    SUBCASE("many small reads") {
+        // every file needs several reads and the reads of different files interleave
+        options.queue_depth = 3;
+        options.chunk_size = 100;
+        options.max_open_files = 2;
+    }
+
+    std::map<std::size_t, std::string> results;
+    hashlib::hash_files_batch<hashlib::sha256>(paths, [&](std::size_t index, hashlib::sha256& ctx, std::error_code ec) {
+        CHECK(results.find(index) == results.end());
+        results[index] = ec ? "error" : ctx.hexdigest();
+    }, options);
+
+    REQUIRE_EQ(results.size(), paths.size());
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+        CHECK_EQ(results[i], filenames[i]);
+    }
+    CHECK_EQ(results[filenames.size()], "error");
+    CHECK_NE(results[filenames.size() + 1], hashlib::sha256{std::string{}}.hexdigest());
+    CHECK_EQ(results[filenames.size() + 1], hashlib::hash_file<hashlib::sha256>(proc_path).hexdigest());
+}
+
+#if HASHLIB_HAS_IO_URING
+TEST_CASE("testing io_uring_ring") {
+    hashlib::detail::io_uring_ring ring{4};
+    if (!ring.valid()) return;
+
+    // the submission queue never overwrites a request which has not been submitted
+    std::vector<io_uring_sqe*> sqes;
+    while (auto sqe = ring.get_sqe()) {
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = sqes.size();
+        sqes.push_back(sqe);
+    }
+    CHECK_EQ(sqes.size(), ring.entries());
+
+    CHECK_EQ(ring.submit_and_wait(static_cast<unsigned>(sqes.size())), 0);
+    CHECK_EQ(ring.in_flight(), sqes.size());
+    std::vector<std::uint64_t> completed;
+    CHECK_EQ(ring.for_each_cqe([&](std::uint64_t user_data, int res) {
+        CHECK_EQ(res, 0);
+        completed.push_back(user_data);
+    }), sqes.size());
+    CHECK_EQ(completed.size(), sqes.size());
+    CHECK_EQ(ring.in_flight(), 0);
+
+    // the queue has room again once the requests are submitted
+    auto sqe = ring.get_sqe();
+    REQUIRE(sqe != nullptr);
+    sqe->opcode = IORING_OP_NOP;
+    CHECK_EQ(ring.submit_and_wait(0), 0);
+    CHECK(ring.wait_in_flight());
+    CHECK_EQ(ring.in_flight(), 0);
+}
+#endif
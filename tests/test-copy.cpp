@@ -0,0 +1,38 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/copy.hpp>
+#include <vector>
+#include "common.h"
+
+TEST_CASE("testing copy_and_hash") {
+    std::vector<char> src(100000);
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<char>(i * 131 + i / 7);
+    }
+
+    for (auto hint : {hashlib::copy_hint::automatic, hashlib::copy_hint::cached, hashlib::copy_hint::streaming}) {
+        for (std::size_t size : {0, 1, 63, 64, 65, 8191, 8192, 8193, 99999}) {
+            // an odd offset, so that the destination is not aligned
+            std::vector<char> dst(size + 3, 'x');
+            hashlib::sha256 ctx;
+            ctx.update(std::string{"prefix"});
+            hashlib::copy_and_hash(dst.data() + 1, src.data(), size, ctx, hint);
+            CHECK(std::equal(src.begin(), src.begin() + size, dst.begin() + 1));
+            CHECK_EQ(dst[0], 'x');
+            CHECK_EQ(dst[size + 1], 'x');
+            CHECK_EQ(ctx.hexdigest(), hashlib::sha256{"prefix" + std::string{src.begin(), src.begin() + size}}.hexdigest());
+        }
+    }
+
+    SUBCASE("large copy") {
+        std::vector<char> large(hashlib::copy_streaming_threshold + 12345);
+        for (std::size_t i = 0; i < large.size(); ++i) {
+            large[i] = static_cast<char>(i ^ (i >> 11));
+        }
+        std::vector<char> dst(large.size());
+        hashlib::md5 ctx;
+        hashlib::copy_and_hash(dst.data(), large.data(), large.size(), ctx);
+        CHECK(dst == large);
+        CHECK_EQ(ctx.hexdigest(), hashlib::md5{large}.hexdigest());
+    }
+}
@@ -0,0 +1,67 @@
+#include <list>
+#include <vector>
+#include <hashlib/each.hpp>
+#include <hashlib/md5.hpp>
+#include <hashlib/sha2.hpp>
+#include "common.h"
+
+namespace {
+    // messages of every size around the blocks, and a few large ones which get tasks of their own.
+    auto make_messages() -> std::vector<std::string> {
+        std::vector<std::string> messages;
+        for (std::size_t i = 0; i < 300; ++i) {
+            messages.emplace_back(i * 7 % 257, static_cast<char>('a' + i % 26));
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            messages.emplace_back((std::size_t(1) << 20) + i, static_cast<char>('0' + i));
+        }
+        return messages;
+    }
+
+    template<typename Algo, typename Policy>
+    auto check_policy(const Policy& policy, const std::vector<std::string>& messages) -> void {
+        std::vector<std::array<hashlib::byte, Algo::digest_size>> digests(messages.size());
+        auto end = hashlib::hash_each<Algo>(policy, messages.begin(), messages.end(), digests.begin());
+        CHECK(end == digests.end());
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            CAPTURE(i);
+            CHECK_EQ(digests[i], Algo{messages[i]}.digest());
+        }
+    }
+}
+
+TEST_CASE("testing hash_each") {
+    const auto messages = make_messages();
+
+    SUBCASE("sequenced") {
+        std::list<std::string> list(messages.begin(), messages.end());
+        std::vector<std::array<hashlib::byte, 32>> digests;
+        hashlib::hash_each<hashlib::sha256>(hashlib::execution::seq, list.begin(), list.end(), std::back_inserter(digests));
+        REQUIRE_EQ(digests.size(), messages.size());
+        CHECK_EQ(digests.front(), hashlib::sha256{messages.front()}.digest());
+        CHECK_EQ(digests.back(), hashlib::sha256{messages.back()}.digest());
+    }
+
+    SUBCASE("unsequenced") {
+        check_policy<hashlib::sha256>(hashlib::execution::unseq, messages);
+        check_policy<hashlib::sha224>(hashlib::execution::unseq, messages);
+        // without a multi-buffer kernel the messages are hashed one after another
+        check_policy<hashlib::md5>(hashlib::execution::unseq, messages);
+    }
+
+    SUBCASE("parallel unsequenced") {
+        hashlib::thread_pool pool{4};
+        check_policy<hashlib::sha256>(hashlib::execution::par_unseq.on(pool.get_executor()), messages);
+        check_policy<hashlib::md5>(hashlib::execution::par_unseq.on(pool.get_executor()), messages);
+        check_policy<hashlib::sha256>(hashlib::execution::par_unseq, messages);
+        // too few bytes for the threads
+        check_policy<hashlib::sha256>(hashlib::execution::par_unseq, std::vector<std::string>{"abc", "", "def"});
+    }
+
+    SUBCASE("range") {
+        auto digests = hashlib::hash_each<hashlib::sha256>(hashlib::execution::par_unseq, messages);
+        REQUIRE_EQ(digests.size(), messages.size());
+        CHECK_EQ(digests[5], hashlib::sha256{messages[5]}.digest());
+        CHECK(hashlib::hash_each<hashlib::sha256>(hashlib::execution::unseq, std::vector<std::string>{}).empty());
+    }
+}
@@ -0,0 +1,69 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/file.hpp>
+#include "common.h"
+
+TEST_CASE("testing hash_file") {
+    SUBCASE("small files") {
+        std::string dir = HASHLIB_TEST_DIR"/files/sha256/";
+        auto filenames = {
+            "12e3d508453dba4ac11545a1a4f5d684058752f27b1a87c59b4dd270ce6f0c8e",
+            "da1fe846db926bb2522bb8253cd6cf12608787737d54e055493c6389f9a81a67"
+        };
+        for (auto filename : filenames) {
+            SUBCASE(filename) {
+                CHECK_EQ(hashlib::hash_file<hashlib::sha256>(dir + filename).hexdigest(), filename);
+            }
+        }
+    }
+
+    SUBCASE("large file") {
+        // larger than the mapping threshold and not a multiple of the page size
+        std::string content;
+        for (std::size_t i = 0; i < (std::size_t(3) << 20) + 12345; ++i) {
+            content.push_back(static_cast<char>(i * 131 + i / 7));
+        }
+        const char* filename = "hashlib-test-large-file.bin";
+        {
+            std::ofstream file{filename, std::ios::out | std::ios::binary};
+            REQUIRE(file.is_open());
+            file << content;
+        }
+        auto expected = hashlib::md5{content}.hexdigest();
+        CHECK_EQ(hashlib::hash_file<hashlib::md5>(filename).hexdigest(), expected);
+
+        SUBCASE("pipelined") {
+            hashlib::file_reader_options options;
+            options.buffer_size = 100000;
+            options.depth = 3;
+            SUBCASE("default") {}
+            SUBCASE("direct io") {
+                options.direct_io = true;
+            }
+            SUBCASE("huge pages") {
+                options.huge_pages = true;
+            }
+            SUBCASE("single buffer") {
+                options.depth = 1;
+            }
+            CHECK_EQ(hashlib::hash_file<hashlib::md5>(filename, options).hexdigest(), expected);
+        }
+        std::remove(filename);
+    }
+
+    SUBCASE("missing file") {
+        std::error_code ec;
+        auto md5 = hashlib::hash_file<hashlib::md5>(HASHLIB_TEST_DIR"/files/no-such-file", ec);
+        CHECK(ec);
+        CHECK_EQ(md5.hexdigest(), "d41d8cd98f00b204e9800998ecf8427e");
+        CHECK_THROWS_AS((void)hashlib::hash_file<hashlib::md5>(HASHLIB_TEST_DIR"/files/no-such-file"), std::system_error);
+        (void)hashlib::hash_file<hashlib::md5>(HASHLIB_TEST_DIR"/files/no-such-file", hashlib::file_reader_options{}, ec);
+        CHECK(ec);
+    }
+
+#if HASHLIB_PLATFORM_POSIX
+    SUBCASE("special file") {
+        CHECK_EQ(hashlib::hash_file<hashlib::md5>("/dev/null").hexdigest(), "d41d8cd98f00b204e9800998ecf8427e");
+    }
+#endif
+}
@@ -0,0 +1,50 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha1.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include "common.h"
+
+namespace {
+    template<typename Algo>
+    auto check_sizes(const hashlib::byte*) -> void {}
+
+    template<typename Algo, std::size_t N, std::size_t... Ns>
+    auto check_sizes(const hashlib::byte* data) -> void {
+        CAPTURE(N);
+        CHECK_EQ(hashlib::hash_fixed<Algo, N>(data), Algo{hashlib::span<const hashlib::byte>{data, N}}.digest());
+        check_sizes<Algo, Ns...>(data);
+    }
+
+    // the sizes around the ends of the 64, 128, 136 and 144 byte blocks, where the padding changes its shape.
+    template<typename Algo>
+    auto check_algorithm(const hashlib::byte* data) -> void {
+        check_sizes<Algo,
+            0, 1, 32, 55, 56, 63, 64, 65, 111, 112, 119, 120, 127, 128, 129,
+            135, 136, 137, 143, 144, 200, 256, 4096
+        >(data);
+    }
+}
+
+TEST_CASE("testing hash_fixed") {
+    std::array<hashlib::byte, 4096> data; // NOLINT(*-pro-type-member-init)
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<hashlib::byte>(i * 131 + i / 7);
+    }
+
+    check_algorithm<hashlib::md5>(data.data());
+    check_algorithm<hashlib::sha1>(data.data());
+    check_algorithm<hashlib::sha224>(data.data());
+    check_algorithm<hashlib::sha256>(data.data());
+    check_algorithm<hashlib::sha384>(data.data());
+    check_algorithm<hashlib::sha512>(data.data());
+    check_algorithm<hashlib::sha3_224>(data.data());
+    check_algorithm<hashlib::sha3_256>(data.data());
+    check_algorithm<hashlib::sha3_384>(data.data());
+    check_algorithm<hashlib::sha3_512>(data.data());
+
+    SUBCASE("array") {
+        std::array<hashlib::byte, 32> key{};
+        CHECK_EQ(hashlib::hash_fixed<hashlib::sha256>(key), hashlib::sha256{key}.digest());
+        CHECK_EQ(hashlib::hash_fixed<hashlib::sha256, 0>(nullptr), hashlib::sha256{}.digest());
+    }
+}
@@ -0,0 +1,103 @@
+#include <list>
+#include <map>
+#include <tuple>
+#include <vector>
+#include <hashlib/hash_append.hpp>
+#include <hashlib/sha2.hpp>
+#include "common.h"
+
+namespace geometry {
+    struct point {
+        std::int32_t x;
+        std::int32_t y;
+    };
+
+    template<typename H>
+    auto hash_append(H& h, const point& p) -> void {
+        hashlib::hash_append(h, p.x, p.y);
+    }
+
+    enum class color : std::uint16_t { red = 1, green = 0x0102 };
+
+#if HASHLIB_CXX_STANDARD >= HASHLIB_CXX_STD17
+    struct record {
+        std::uint8_t kind;
+        std::string name;
+        point origin;
+    };
+
+    struct sample {
+        std::uint16_t id;
+        std::int32_t values[3];
+        char tag[2];
+    };
+#endif
+}
+
+namespace {
+    auto digest_of(const std::string& bytes) -> std::array<hashlib::byte, 32> {
+        return hashlib::sha256{bytes}.digest();
+    }
+
+    template<typename... Ts>
+    auto appended(const Ts&... values) -> std::array<hashlib::byte, 32> {
+        hashlib::sha256 ctx;
+        hashlib::hash_append(ctx, values...);
+        return ctx.digest();
+    }
+}
+
+TEST_CASE("testing hash_append") {
+    using std::string;
+
+    SUBCASE("integers") {
+        CHECK_EQ(appended(std::uint32_t{0x01020304}), digest_of(string("\x04\x03\x02\x01", 4)));
+        CHECK_EQ(appended(std::int16_t{-2}), digest_of(string("\xfe\xff", 2)));
+        CHECK_EQ(appended(hashlib::big_endian(std::uint32_t{0x01020304})), digest_of(string("\x01\x02\x03\x04", 4)));
+        CHECK_EQ(appended(hashlib::little_endian(std::uint16_t{0x0102})), digest_of(string("\x02\x01", 2)));
+        CHECK_EQ(appended(true, false, 'a'), digest_of(string("\x01\x00" "a", 3)));
+        CHECK_EQ(appended(geometry::color::green), digest_of(string("\x02\x01", 2)));
+    }
+
+    SUBCASE("ranges") {
+        CHECK_EQ(appended(string("ab")), digest_of(string("ab\x02\0\0\0\0\0\0\0", 10)));
+        CHECK_EQ(appended(std::vector<std::uint16_t>{1, 2}), digest_of(string("\x01\0\x02\0\x02\0\0\0\0\0\0\0", 12)));
+        CHECK_EQ(appended(std::list<std::uint16_t>{1, 2}), appended(std::vector<std::uint16_t>{1, 2}));
+        CHECK_NE(appended(string("ab"), string("c")), appended(string("a"), string("bc")));
+        CHECK_EQ(appended(std::vector<string>{"a", "bc"}), appended(string("a"), string("bc"), std::uint64_t{2}));
+        std::map<int, string> m{{1, "a"}, {2, "b"}};
+        CHECK_EQ(appended(m), appended(1, string("a"), 2, string("b"), std::uint64_t{2}));
+    }
+
+    SUBCASE("tuples and user types") {
+        CHECK_EQ(appended(std::make_pair(1, string("a"))), appended(1, string("a")));
+        CHECK_EQ(appended(std::make_tuple(std::uint8_t{1}, 2, string("a"))), appended(std::uint8_t{1}, 2, string("a")));
+        CHECK_EQ(appended(geometry::point{1, -1}), digest_of(string("\x01\0\0\0\xff\xff\xff\xff", 8)));
+        std::vector<geometry::point> points{{1, 2}, {3, 4}};
+        CHECK_EQ(appended(points), appended(1, 2, 3, 4, std::uint64_t{2}));
+#if HASHLIB_CXX_STANDARD >= HASHLIB_CXX_STD17
+        CHECK_EQ(appended(geometry::record{7, "name", {1, 2}}), appended(std::uint8_t{7}, string("name"), 1, 2));
+        // an array field is one field, appended as a range
+        CHECK_EQ(appended(geometry::sample{5, {1, 2, 3}, {'a', 'b'}}),
+                 appended(std::uint16_t{5}, std::vector<std::int32_t>{1, 2, 3}, string("ab")));
+#endif
+    }
+
+    SUBCASE("appender") {
+        // the fields are put into the partial block of the context, some cross the end of a block and some are longer
+        hashlib::sha256 ctx;
+        hashlib::hash_appender<hashlib::sha256> h{ctx};
+        string expected;
+        auto put_le = [&expected](std::uint64_t value, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) expected += static_cast<char>(value >> (8 * i));
+        };
+        for (std::uint32_t i = 0; i < 1000; ++i) {
+            string field(i % 300, static_cast<char>('a' + i % 26));
+            hashlib::hash_append(h, i, field);
+            put_le(i, 4);
+            expected += field;
+            put_le(field.size(), 8);
+        }
+        CHECK_EQ(ctx.digest(), digest_of(expected));
+    }
+}
@@ -0,0 +1,61 @@
+#include <stdexcept>
+#include <hashlib/hasher.hpp>
+#include "common.h"
+
+namespace {
+    template<typename Algo>
+    auto check_hasher(const char* name, std::size_t block_size, const std::string& content) -> void {
+        CAPTURE(name);
+        auto h = hashlib::hasher::create(name);
+        CHECK_EQ(std::string{h.name()}, name);
+        const std::size_t digest_size = Algo::digest_size;
+        CHECK_EQ(h.digest_size(), digest_size);
+        CHECK_EQ(h.block_size(), block_size);
+
+        h.update(content.substr(0, 1000));
+        auto copy = h;
+        h.update(content.substr(1000));
+        CHECK_EQ(h.hexdigest(), Algo{content}.hexdigest());
+        CHECK_EQ(copy.hexdigest(), Algo{content.substr(0, 1000)}.hexdigest());
+
+        // the chunks of a batch are hashed one after another
+        auto bytes = reinterpret_cast<const hashlib::byte*>(content.data());
+        const hashlib::span<const hashlib::byte> chunks[] = {{bytes, 3}, {bytes + 3, 0}, {bytes + 3, 997}};
+        copy.clear();
+        copy.update({chunks, 3});
+        std::vector<hashlib::byte> out(digest_size);
+        copy.digest({out.data(), out.size()});
+        auto expected = Algo{content.substr(0, 1000)}.digest();
+        CHECK(std::equal(out.begin(), out.end(), expected.begin()));
+
+        // separate messages
+        std::vector<hashlib::span<const hashlib::byte>> messages;
+        for (std::size_t i = 0; i < 20; ++i) messages.push_back({bytes + i, i * 37});
+        std::vector<hashlib::byte> digests(messages.size() * h.digest_size());
+        h.digest_each({messages.data(), messages.size()}, {digests.data(), digests.size()});
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            auto d = Algo{messages[i]}.digest();
+            CHECK(std::equal(d.begin(), d.end(), digests.begin() + static_cast<std::ptrdiff_t>(i * d.size())));
+        }
+        CHECK_THROWS_AS(h.digest_each({messages.data(), messages.size()}, {digests.data(), 1}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("testing hasher") {
+    std::string content;
+    for (std::size_t i = 0; i < 5000; ++i) content.push_back(static_cast<char>(i * 13 + i / 5));
+
+    check_hasher<hashlib::md5>("md5", 64, content);
+    check_hasher<hashlib::sha1>("sha1", 64, content);
+    check_hasher<hashlib::sha224>("sha224", 64, content);
+    check_hasher<hashlib::sha256>("sha256", 64, content);
+    check_hasher<hashlib::sha384>("sha384", 128, content);
+    check_hasher<hashlib::sha512>("sha512", 128, content);
+    check_hasher<hashlib::sha3_224>("sha3_224", 144, content);
+    check_hasher<hashlib::sha3_256>("sha3_256", 136, content);
+    check_hasher<hashlib::sha3_384>("sha3_384", 104, content);
+    check_hasher<hashlib::sha3_512>("sha3_512", 72, content);
+
+    CHECK_EQ(hashlib::hasher::algorithms().size(), 10);
+    CHECK_THROWS_AS((void)hashlib::hasher::create("sha257"), std::invalid_argument);
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <cctype>
+#include <list>
+#include <hashlib/iterator.hpp>
+#include <hashlib/md5.hpp>
+#include <hashlib/multi.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include "common.h"
+
+TEST_CASE("testing hash_output_iterator") {
+    std::string input;
+    for (int i = 0; i < 10000; ++i) input += static_cast<char>('a' + i % 26);
+
+    SUBCASE("copy") {
+        std::list<char> chars(input.begin(), input.end());
+        hashlib::sha256 ctx;
+        auto it = std::copy(chars.begin(), chars.end(), hashlib::hash_output(ctx));
+        *it++ = '!';
+        // the iterator is still alive, so its bytes are handed over explicitly
+        it.flush();
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{input + "!"}.hexdigest());
+    }
+
+    SUBCASE("transform") {
+        hashlib::sha3_256 ctx;
+        std::transform(input.begin(), input.end(), hashlib::hash_output(ctx), [](char c) {
+            return static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(c)));
+        });
+        std::string upper = input;
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](char c) {
+            return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        });
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha3_256{upper}.hexdigest());
+    }
+
+    SUBCASE("multi") {
+        // multi has no block size of its own
+        hashlib::multi<hashlib::md5, hashlib::sha256> ctx;
+        std::copy(input.begin(), input.end(), hashlib::hash_output(ctx));
+        CHECK_EQ(ctx.digests(), hashlib::multi<hashlib::md5, hashlib::sha256>{input}.digests());
+    }
+
+    SUBCASE("copies hand over the collected bytes") {
+        hashlib::sha256 ctx;
+        {
+            auto a = hashlib::hash_output(ctx);
+            *a++ = 'a';
+            auto b = a;
+            *b++ = 'b';
+            auto c = hashlib::hash_output(ctx);
+            c = b;
+            *c++ = 'c';
+        }
+        CHECK_EQ(ctx.hexdigest(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    }
+}
@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+#include <hashlib/sha2.hpp>
+#include <hashlib/pool.hpp>
+#include "common.h"
+
+namespace {
+    template<typename Kernel>
+    auto check_kernel() -> void {
+        using namespace hashlib_testing::literals;
+        using sha224 = hashlib::sha224_t<Kernel>;
+        using sha256 = hashlib::sha256_t<Kernel>;
+
+        CHECK_EQ(sha256{}.hexdigest(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        CHECK_EQ(sha256{"hello world"_s}.hexdigest(), "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+        CHECK_EQ(sha224{"hello world"_s}.hexdigest(), "2f05477fc24bb4faefd86517156dafdecec45b8ad3cf2522a563582b");
+
+        // every length around the block and padding boundaries, fed at once and byte by byte.
+        std::string input;
+        for (std::size_t i = 0; i < 300; ++i) {
+            input.push_back(static_cast<char>(i * 7 + 1));
+            sha256 ctx;
+            for (char c : input) ctx.update(std::string(1, c));
+            CHECK_EQ(sha256{input}.hexdigest(), hashlib::sha256{input}.hexdigest());
+            CHECK_EQ(ctx.hexdigest(), hashlib::sha256{input}.hexdigest());
+            CHECK_EQ(sha224{input}.hexdigest(), hashlib::sha224{input}.hexdigest());
+        }
+
+        // `hash_fixed` with a constant padding block, with a tail block, and with both.
+        const auto* data = reinterpret_cast<const hashlib::byte*>(input.data());
+        CHECK_EQ(hashlib::hash_fixed<sha256, 64>(data), hashlib::sha256{input.substr(0, 64)}.digest());
+        CHECK_EQ(hashlib::hash_fixed<sha256, 100>(data), hashlib::sha256{input.substr(0, 100)}.digest());
+        CHECK_EQ(hashlib::hash_fixed<sha256, 60>(data), hashlib::sha256{input.substr(0, 60)}.digest());
+    }
+}
+
+TEST_CASE("testing kernels") {
+    SUBCASE("portable") {
+        check_kernel<hashlib::kernel::portable>();
+    }
+
+    SUBCASE("native") {
+        check_kernel<hashlib::kernel::native>();
+    }
+
+#if HASHLIB_HAS_SHANI
+    SUBCASE("shani") {
+        check_kernel<hashlib::kernel::shani>();
+    }
+#endif
+
+    SUBCASE("lanes") {
+        using sha256 = hashlib::sha256_t<hashlib::kernel::native>;
+        CHECK(std::is_same<hashlib::detail::lane_kernel<sha256>::type, hashlib::detail::sha256_lanes>::value);
+        hashlib::context_pool<sha256> pool{4};
+        auto stream = pool.open();
+        std::string input(1000, 'a');
+        pool.update(stream, {reinterpret_cast<const hashlib::byte*>(input.data()), input.size()});
+        CHECK_EQ(pool.digest(stream), hashlib::sha256{input}.digest());
+    }
+}
@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/md5.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing md5") {
         CHECK_EQ(md5.hexdigest(), "5eb63bbbe01eeed093cb22bb8f5acdc3");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        md5.update(bytes.begin(), bytes.begin() + 5);
+        md5.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(md5.hexdigest(), "5eb63bbbe01eeed093cb22bb8f5acdc3");
+    }
+
     SUBCASE("multiple updates") {
         md5.update("hello"_s);
         md5.update(" "_s);
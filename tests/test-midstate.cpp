@@ -0,0 +1,95 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha1.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+#include "common.h"
+
+namespace {
+    template<typename Algo, std::size_t BlockSize>
+    auto check_midstate(const std::string& content) -> void {
+        const std::string prefix = content.substr(0, 3 * BlockSize);
+        const std::vector<std::string> suffixes{"", "a", content.substr(0, 100), content.substr(7, 1000)};
+
+        Algo prefix_ctx{prefix.substr(0, BlockSize - 1)};
+        prefix_ctx.update(prefix.substr(BlockSize - 1));
+        REQUIRE(prefix_ctx.at_block_boundary());
+        auto state = prefix_ctx.midstate();
+        CHECK_EQ(state.size, prefix.size());
+
+        for (const auto& suffix : suffixes) {
+            auto resumed = Algo::from_midstate(state);
+            resumed.update(suffix);
+            CHECK_EQ(resumed.hexdigest(), Algo{prefix + suffix}.hexdigest());
+        }
+
+        auto digests = hashlib::hash_suffixes<Algo>(state, suffixes);
+        REQUIRE_EQ(digests.size(), suffixes.size());
+        for (std::size_t i = 0; i < suffixes.size(); ++i) {
+            CHECK_EQ(digests[i], Algo{prefix + suffixes[i]}.digest());
+        }
+
+        // forking works at any point, the partial block goes with the fork
+        Algo partial{content.substr(0, 1001)};
+        CHECK_FALSE(partial.at_block_boundary());
+        CHECK_THROWS_AS((void)partial.midstate(), std::logic_error);
+        auto fork = partial.fork();
+        fork.update(content.substr(1001));
+        CHECK_EQ(fork.hexdigest(), Algo{content}.hexdigest());
+        CHECK_EQ(partial.hexdigest(), Algo{content.substr(0, 1001)}.hexdigest());
+        CHECK_EQ(hashlib::hash_suffixes(partial, suffixes)[2], Algo{content.substr(0, 1001) + suffixes[2]}.digest());
+
+        state.size += 1;
+        CHECK_THROWS_AS((void)Algo::from_midstate(state), std::invalid_argument);
+    }
+}
+
+TEST_CASE("testing midstate") {
+    std::string content;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+
+    check_midstate<hashlib::md5, 64>(content);
+    check_midstate<hashlib::sha1, 64>(content);
+    check_midstate<hashlib::sha224, 64>(content);
+    check_midstate<hashlib::sha256, 64>(content);
+    check_midstate<hashlib::sha384, 128>(content);
+    check_midstate<hashlib::sha512, 128>(content);
+    check_midstate<hashlib::sha3_224, 144>(content);
+    check_midstate<hashlib::sha3_256, 136>(content);
+    check_midstate<hashlib::sha3_384, 104>(content);
+    check_midstate<hashlib::sha3_512, 72>(content);
+}
+
+TEST_CASE("testing hash_suffixes on the lanes") {
+    std::string content;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+    // more suffixes than a batch of the lanes, of every length around the block and padding boundaries
+    std::vector<std::string> suffixes;
+    for (std::size_t i = 0; i < 150; ++i) {
+        suffixes.push_back(content.substr(i, i % 2 == 0 ? i : 3 * i));
+    }
+
+    hashlib::sha256 prefix{content.substr(0, 1001)};
+    auto digests = hashlib::hash_suffixes(prefix, suffixes);
+    REQUIRE_EQ(digests.size(), suffixes.size());
+    for (std::size_t i = 0; i < suffixes.size(); ++i) {
+        CHECK_EQ(digests[i], hashlib::sha256{content.substr(0, 1001) + suffixes[i]}.digest());
+    }
+    CHECK_EQ(prefix.hexdigest(), hashlib::sha256{content.substr(0, 1001)}.hexdigest());
+
+    // the suffixes which are not contiguous are hashed one at a time
+    std::vector<std::deque<char>> deques;
+    for (std::size_t i = 0; i < 3; ++i) deques.emplace_back(suffixes[i * 40].begin(), suffixes[i * 40].end());
+    auto deque_digests = hashlib::hash_suffixes(prefix, deques);
+    for (std::size_t i = 0; i < deques.size(); ++i) {
+        CHECK_EQ(deque_digests[i], digests[i * 40]);
+    }
+
+    CHECK(hashlib::hash_suffixes(prefix, std::vector<std::string>{}).empty());
+}
@@ -0,0 +1,56 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha1.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include <hashlib/multi.hpp>
+#include <list>
+#include <sstream>
+#include "common.h"
+
+TEST_CASE("testing multi") {
+    std::string content;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+    using multi = hashlib::multi<hashlib::md5, hashlib::sha1, hashlib::sha256, hashlib::sha3_512>;
+    std::array<std::string, 4> expected{{
+        hashlib::md5{content}.hexdigest(),
+        hashlib::sha1{content}.hexdigest(),
+        hashlib::sha256{content}.hexdigest(),
+        hashlib::sha3_512{content}.hexdigest()
+    }};
+
+    SUBCASE("single pass") {
+        multi ctx{content};
+        CHECK_EQ(ctx.hexdigests(), expected);
+        CHECK_EQ(ctx.hexdigest(), expected[0] + expected[1] + expected[2] + expected[3]);
+        CHECK_EQ(std::get<1>(ctx.digests()), hashlib::sha1{content}.digest());
+        CHECK_EQ(ctx.get<2>().hexdigest(), expected[2]);
+        CHECK_EQ(multi::digest_size, 16 + 20 + 32 + 64);
+    }
+
+    SUBCASE("several updates") {
+        multi ctx;
+        std::list<char> list(content.begin(), content.begin() + 1000);
+        ctx.update(list);
+        ctx.update(content.data() + 1000, content.data() + 50001);
+        std::istringstream stream{content.substr(50001)};
+        ctx.update(stream);
+        CHECK_EQ(ctx.hexdigests(), expected);
+        ctx.clear();
+        CHECK_EQ(ctx.get<0>().hexdigest(), hashlib::md5{}.hexdigest());
+    }
+
+    SUBCASE("executor") {
+        multi ctx;
+        hashlib::span<const hashlib::byte> bytes{reinterpret_cast<const hashlib::byte*>(content.data()), content.size()};
+        SUBCASE("thread pool") {
+            hashlib::thread_pool pool{2};
+            ctx.update(bytes, pool.get_executor());
+        }
+        SUBCASE("inline") {
+            ctx.update(bytes, hashlib::inline_executor{});
+        }
+        CHECK_EQ(ctx.hexdigests(), expected);
+    }
+}
@@ -0,0 +1,139 @@
+#include <map>
+#include <hashlib/sha2.hpp>
+#include <hashlib/parallel.hpp>
+#include "common.h"
+
+TEST_CASE("testing hash_files") {
+    std::string dir = HASHLIB_TEST_DIR"/files/sha256/";
+    std::vector<std::string> filenames{
+        "12e3d508453dba4ac11545a1a4f5d684058752f27b1a87c59b4dd270ce6f0c8e",
+        "193442bab43399feb8a9f755b67197563e69a4a5e24eb9d25a801e14199f4d93",
+        "551b4599583cac123c4b26e1fa9d1a2009bb2c8700aa925d917f18fb30cef0eb",
+        "6daf2e956ed820815f64d61bd78d35b162507009bf7e73e46767d58cb409df12",
+        "86c7242ddf4762df914d53adeb7fc9eeecd4ba0fbdbc98d38925b9d115512deb",
+        "931a305319903cfbbec6bcac57ec4b9a00893079e7a998caf44250cb949fab67",
+        "c61f9e7c137384497ed0864e649f13dbc82d2608b2c8b573aff13f7a857a4bd8",
+        "da1fe846db926bb2522bb8253cd6cf12608787737d54e055493c6389f9a81a67"
+    };
+    std::vector<std::string> paths;
+    for (int round = 0; round < 4; ++round) {
+        for (const auto& filename : filenames) {
+            paths.push_back(dir + filename);
+        }
+    }
+    paths.push_back(dir + "no-such-file");
+
+    hashlib::parallel_options options;
+    options.threads = 4;
+    SUBCASE("default options") {}
+    SUBCASE("large files") {
+        // most files are split into chunks which are read by several tasks
+        options.large_file_threshold = 1000;
+        options.chunk_size = 100;
+        options.read_ahead = 3;
+    }
+    SUBCASE("single thread") {
+        options.threads = 1;
+        options.large_file_threshold = 1000;
+        options.chunk_size = 333;
+    }
+
+    SUBCASE("in order") {
+        auto results = hashlib::hash_files<hashlib::sha256>(paths, options);
+        REQUIRE_EQ(results.size(), paths.size());
+        for (std::size_t i = 0; i + 1 < paths.size(); ++i) {
+            CHECK_FALSE(results[i].ec);
+            CHECK_EQ(results[i].context.hexdigest(), filenames[i % filenames.size()]);
+        }
+        CHECK(results.back().ec);
+    }
+
+    SUBCASE("executors") {
+        std::vector<hashlib::file_hash_result<hashlib::sha256>> results;
+        SUBCASE("thread pool") {
+            hashlib::thread_pool pool{3};
+            results = hashlib::hash_files<hashlib::sha256>(paths, pool.get_executor(), options);
+        }
+        SUBCASE("inline") {
+            results = hashlib::hash_files<hashlib::sha256>(paths, hashlib::inline_executor{}, options);
+        }
+        SUBCASE("adapter") {
+            // a plain pool of threads sharing one queue
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::deque<std::function<void()>> tasks;
+            bool stopping = false;
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 2; ++i) {
+                threads.emplace_back([&] {
+                    for (;;) {
+                        std::unique_lock<std::mutex> lock{mutex};
+                        cv.wait(lock, [&] { return !tasks.empty() || stopping; });
+                        if (tasks.empty()) return;
+                        auto task = std::move(tasks.front());
+                        tasks.pop_front();
+                        lock.unlock();
+                        task();
+                    }
+                });
+            }
+            auto executor = hashlib::make_executor([&](std::function<void()> task) {
+                std::lock_guard<std::mutex> lock{mutex};
+                tasks.push_back(std::move(task));
+                cv.notify_one();
+            }, threads.size());
+            results = hashlib::hash_files<hashlib::sha256>(paths, executor, options);
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto& thread : threads) thread.join();
+        }
+        REQUIRE_EQ(results.size(), paths.size());
+        for (std::size_t i = 0; i + 1 < paths.size(); ++i) {
+            CHECK_EQ(results[i].context.hexdigest(), filenames[i % filenames.size()]);
+        }
+        CHECK(results.back().ec);
+    }
+
+    SUBCASE("numa placement") {
+        options.large_file_threshold = 1000;
+        options.chunk_size = 100;
+        options.pin_threads = true;
+        std::vector<std::size_t> placed;
+        options.on_placement = [&](std::size_t index, const hashlib::numa_placement& placement) {
+            placed.push_back(index);
+            CHECK_LT(placement.node, static_cast<int>(hashlib::numa_node_count()));
+        };
+        auto results = hashlib::hash_files<hashlib::sha256>(paths, options);
+        for (std::size_t i = 0; i + 1 < paths.size(); ++i) {
+            CHECK_EQ(results[i].context.hexdigest(), filenames[i % filenames.size()]);
+        }
+        // every file except the smallest two is large
+        CHECK_EQ(placed.size(), paths.size() / filenames.size() * (filenames.size() - 2));
+
+        hashlib::thread_pool_options pool_options;
+        pool_options.threads = 3;
+        pool_options.pin_threads = true;
+        hashlib::thread_pool pool{pool_options};
+        REQUIRE_EQ(pool.placements().size(), 3);
+        for (const auto& placement : pool.placements()) {
+            CHECK_EQ(placement.node, hashlib::detail::numa_node_of_cpu(placement.cpu));
+        }
+        CHECK_EQ(hashlib::detail::parse_cpu_list("0-3,8,10-11\n"), std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    }
+
+    SUBCASE("as completed") {
+        std::map<std::size_t, std::string> results;
+        hashlib::hash_files<hashlib::sha256>(paths, [&](std::size_t index, hashlib::sha256& ctx, std::error_code ec) {
+            CHECK(results.find(index) == results.end());
+            results[index] = ec ? "error" : ctx.hexdigest();
+        }, options);
+        REQUIRE_EQ(results.size(), paths.size());
+        for (std::size_t i = 0; i + 1 < paths.size(); ++i) {
+            CHECK_EQ(results[i], filenames[i % filenames.size()]);
+        }
+        CHECK_EQ(results[paths.size() - 1], "error");
+    }
+}
@@ -0,0 +1,80 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include <hashlib/pool.hpp>
+#include <vector>
+#include "common.h"
+
+namespace {
+    template<typename Algo>
+    auto check_pool(const std::string& content) -> void {
+        hashlib::context_pool<Algo> pool{4};
+        std::vector<typename hashlib::context_pool<Algo>::handle> streams;
+        std::vector<Algo> expected;
+        for (std::size_t i = 0; i < 37; ++i) {
+            streams.push_back(pool.open());
+            expected.emplace_back();
+        }
+        CHECK_EQ(pool.size(), 37);
+
+        // writes of every size to many streams, some streams more than once in the same batch
+        std::size_t offset = 0;
+        for (std::size_t round = 0; round < 20; ++round) {
+            std::vector<typename hashlib::context_pool<Algo>::write> writes;
+            for (std::size_t i = 0; i < streams.size(); ++i) {
+                std::size_t n = (i * 37 + round * 101) % 700;
+                if ((i + round) % 5 == 0) n = 0;
+                if (offset + n > content.size()) offset = 0;
+                auto bytes = hashlib::span<const hashlib::byte>{reinterpret_cast<const hashlib::byte*>(content.data()) + offset, n};
+                writes.push_back({streams[i], bytes});
+                expected[i].update(bytes);
+                if (i % 7 == 3) {
+                    writes.push_back({streams[i], bytes.subspan(0, n / 2)});
+                    expected[i].update(bytes.subspan(0, n / 2));
+                }
+                offset += n;
+            }
+            pool.update({writes.data(), writes.size()});
+        }
+
+        for (std::size_t i = 0; i < streams.size(); ++i) {
+            CHECK_EQ(pool.hexdigest(streams[i]), expected[i].hexdigest());
+        }
+
+        pool.close(streams[5]);
+        CHECK_EQ(pool.size(), 36);
+        auto reused = pool.open();
+        CHECK_EQ(reused, streams[5]);
+        pool.update(reused, {reinterpret_cast<const hashlib::byte*>(content.data()), 1000});
+        CHECK_EQ(pool.digest(reused), Algo{content.substr(0, 1000)}.digest());
+        CHECK_EQ(pool.hexdigest(streams[6]), expected[6].hexdigest());
+
+        // a reused handle continuing from a prefix with a partial block, the bytes of its previous stream are gone
+        pool.close(reused);
+        Algo prefix{content.substr(0, 5)};
+        auto continued = pool.open(prefix);
+        CHECK_EQ(continued, reused);
+        pool.update(continued, {reinterpret_cast<const hashlib::byte*>(content.data()) + 5, 200});
+        CHECK_EQ(pool.digest(continued), Algo{content.substr(0, 205)}.digest());
+
+        // the last blocks of several streams at once, the partial blocks cover both one and two padding blocks
+        std::vector<std::array<hashlib::byte, Algo::digest_size>> digests(streams.size());
+        pool.digests({streams.data(), streams.size()}, digests.data());
+        for (std::size_t i = 0; i < streams.size(); ++i) {
+            CHECK_EQ(digests[i], pool.digest(streams[i]));
+        }
+    }
+}
+
+TEST_CASE("testing context_pool") {
+    std::string content;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+
+    check_pool<hashlib::sha256>(content);
+    check_pool<hashlib::sha224>(content);
+    check_pool<hashlib::md5>(content);
+    check_pool<hashlib::sha512>(content);
+    check_pool<hashlib::sha3_256>(content);
+}
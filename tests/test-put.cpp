@@ -0,0 +1,66 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/multi.hpp>
+#include <hashlib/sha1.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include "common.h"
+
+namespace {
+    // a message of small fields which cross every block boundary, once with `put` and once with `update`.
+    template<typename Algo>
+    auto check_put() -> void {
+        Algo put_ctx;
+        Algo update_ctx;
+        std::string expected;
+        for (std::uint32_t i = 0; i < 500; ++i) {
+            switch (i % 5) {
+            case 0:
+                put_ctx.put_u8(static_cast<std::uint8_t>(i));
+                expected += static_cast<char>(i);
+                break;
+            case 1:
+                put_ctx.put_u16_be(static_cast<std::uint16_t>(i));
+                expected += std::string{static_cast<char>(i >> 8), static_cast<char>(i)};
+                break;
+            case 2:
+                put_ctx.put_u32_le(0x01020304u + i);
+                for (int b = 0; b < 4; ++b) expected += static_cast<char>((0x01020304u + i) >> (8 * b));
+                break;
+            case 3:
+                put_ctx.put_u64_be(0x0102030405060708ull * i);
+                for (int b = 7; b >= 0; --b) expected += static_cast<char>((0x0102030405060708ull * i) >> (8 * b));
+                break;
+            default: {
+                std::string field(i % 11, static_cast<char>('a' + i % 26));
+                put_ctx.put({reinterpret_cast<const hashlib::byte*>(field.data()), field.size()});
+                expected += field;
+            }
+            }
+            update_ctx = Algo{expected};
+            CHECK_EQ(put_ctx.digest(), update_ctx.digest());
+        }
+
+        // a write larger than the rest of the block goes through `update`
+        std::string large(300, 'x');
+        put_ctx.put({reinterpret_cast<const hashlib::byte*>(large.data()), large.size()});
+        put_ctx.put_u64_le(42);
+        update_ctx.update(large);
+        update_ctx.update(std::string{42, 0, 0, 0, 0, 0, 0, 0});
+        CHECK_EQ(put_ctx.digest(), update_ctx.digest());
+    }
+}
+
+TEST_CASE("testing put") {
+    SUBCASE("md5") { check_put<hashlib::md5>(); }
+    SUBCASE("sha1") { check_put<hashlib::sha1>(); }
+    SUBCASE("sha256") { check_put<hashlib::sha256>(); }
+    SUBCASE("sha512") { check_put<hashlib::sha512>(); }
+    SUBCASE("sha3_256") { check_put<hashlib::sha3_256>(); }
+    SUBCASE("sha3_512") { check_put<hashlib::sha3_512>(); }
+
+    SUBCASE("multi") {
+        hashlib::multi<hashlib::md5, hashlib::sha256> ctx;
+        ctx.put_u32_be(0x61626364);
+        CHECK_EQ(ctx.digests(), hashlib::multi<hashlib::md5, hashlib::sha256>{std::string{"abcd"}}.digests());
+    }
+}
@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha1.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha1") {
         CHECK_EQ(sha1.hexdigest(), "2aae6c35c94fcfb415dbe95f408b9ce91ee846ed");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha1.update(bytes.begin(), bytes.begin() + 5);
+        sha1.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha1.hexdigest(), "2aae6c35c94fcfb415dbe95f408b9ce91ee846ed");
+    }
+
     SUBCASE("multiple updates") {
         sha1.update("hello"_s);
         sha1.update(" "_s);
@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha2.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha224") {
         CHECK_EQ(sha224.hexdigest(), "2f05477fc24bb4faefd86517156dafdecec45b8ad3cf2522a563582b");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha224.update(bytes.begin(), bytes.begin() + 5);
+        sha224.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha224.hexdigest(), "2f05477fc24bb4faefd86517156dafdecec45b8ad3cf2522a563582b");
+    }
+
     SUBCASE("multiple updates") {
         sha224.update("The quick brown fox "_s);
         sha224.update("jumps over "_s);
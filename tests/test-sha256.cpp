@@ -1,4 +1,6 @@
 #include <deque>
+#include <sstream>
+#include <vector>
 #include <hashlib/sha2.hpp>
 #include "common.h"
 
@@ -15,6 +17,65 @@ TEST_CASE("testing sha256") {
         CHECK_EQ(sha256.hexdigest(), "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha256.update(bytes.begin(), bytes.begin() + 5);
+        sha256.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha256.hexdigest(), "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+    }
+
+    SUBCASE("segmented iterators") {
+        std::string input(5000, 'a');
+        std::deque<char> bytes(input.begin(), input.end());
+        bytes.push_front('b');
+        bytes.pop_front();
+        sha256.update(bytes.begin(), bytes.begin() + 1000);
+        sha256.update(bytes.begin() + 1000, bytes.end());
+        CHECK_EQ(sha256.hexdigest(), hashlib::sha256{input}.hexdigest());
+    }
+
+    SUBCASE("deque segments") {
+        // distinct bytes and a front which starts in the middle of a node, split at every offset of a few nodes.
+        std::string input;
+        for (std::size_t i = 0; i < 10000; ++i) input.push_back(static_cast<char>(i * 31 + i / 256));
+        std::deque<char> bytes(input.begin() + 3000, input.end());
+        for (auto i = input.rend() - 3000; i != input.rend(); ++i) bytes.push_front(*i);
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION) || defined(_MSVC_STL_VERSION)
+        CHECK(hashlib::detail::is_segmented_iterator<std::deque<char>::iterator>::value);
+        CHECK(hashlib::detail::is_segmented_iterator<std::deque<char>::const_iterator>::value);
+#endif
+        // the reverse iterators go through the generic path, as the deque iterators do with other libraries.
+        CHECK_FALSE(hashlib::detail::is_segmented_iterator<std::deque<char>::reverse_iterator>::value);
+        std::deque<char> reversed(input.rbegin(), input.rend());
+        auto expected = hashlib::sha256{input}.hexdigest();
+        for (std::size_t split = 0; split < 5000; split += 37) {
+            hashlib::sha256 segmented;
+            segmented.update(bytes.cbegin(), bytes.cbegin() + split);
+            segmented.update(bytes.cbegin() + split, bytes.cend());
+            CHECK_EQ(segmented.hexdigest(), expected);
+            hashlib::sha256 generic;
+            generic.update(reversed.rbegin(), reversed.rbegin() + split);
+            generic.update(reversed.rbegin() + split, reversed.rend());
+            CHECK_EQ(generic.hexdigest(), expected);
+        }
+    }
+
+    SUBCASE("streams") {
+        std::istringstream input{std::string(1000, 'a')};
+        SUBCASE("istream") {
+            sha256.update(input);
+            CHECK(input.eof());
+        }
+        SUBCASE("streambuf") {
+            sha256.update(*input.rdbuf());
+        }
+        SUBCASE("istreambuf_iterator") {
+            sha256.update(std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+        }
+        CHECK_EQ(sha256.hexdigest(), "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+    }
+
     SUBCASE("multiple updates") {
         sha256.update("hello"_s);
         sha256.update(" "_s);
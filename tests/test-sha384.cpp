@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha2.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha384") {
         CHECK_EQ(sha384.hexdigest(), "fdbd8e75a67f29f701a4e040385e2e23986303ea10239211af907fcbb83578b3e417cb71ce646efd0819dd8c088de1bd");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha384.update(bytes.begin(), bytes.begin() + 5);
+        sha384.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha384.hexdigest(), "fdbd8e75a67f29f701a4e040385e2e23986303ea10239211af907fcbb83578b3e417cb71ce646efd0819dd8c088de1bd");
+    }
+
     SUBCASE("multiple updates") {
         sha384.update("The"_s);
         sha384.update(" quick "_s);
@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha3.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha3_224") {
         CHECK_EQ(sha3_224.hexdigest(), "dfb7f18c77e928bb56faeb2da27291bd790bc1045cde45f3210bb6c5");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha3_224.update(bytes.begin(), bytes.begin() + 5);
+        sha3_224.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha3_224.hexdigest(), "dfb7f18c77e928bb56faeb2da27291bd790bc1045cde45f3210bb6c5");
+    }
+
     SUBCASE("multiple updates") {
         sha3_224.update("The quick brown fox "_s);
         sha3_224.update("jumps over "_s);
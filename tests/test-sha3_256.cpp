@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha3.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha3_256") {
         CHECK_EQ(sha3_256.hexdigest(), "644bcc7e564373040999aac89e7622f3ca71fba1d972fd94a31c3bfbf24e3938");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha3_256.update(bytes.begin(), bytes.begin() + 5);
+        sha3_256.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha3_256.hexdigest(), "644bcc7e564373040999aac89e7622f3ca71fba1d972fd94a31c3bfbf24e3938");
+    }
+
     SUBCASE("multiple updates") {
         sha3_256.update("The quick brown fox "_s);
         sha3_256.update("jumps over "_s);
@@ -22,6 +31,20 @@ TEST_CASE("testing sha3_256") {
         CHECK_EQ(sha3_256.hexdigest(), "69070dda01975c8c120c3aada1b282394e7f032fa9cf32f4cb2259a0897dfc04");
     }
 
+    SUBCASE("unaligned updates") {
+        // the partial block is absorbed byte by byte and word by word, at every offset of the 136 byte block
+        std::string input(1000, 'a');
+        for (std::size_t i = 0; i < input.size(); ++i) input[i] = static_cast<char>(i * 7 + 3);
+        for (std::size_t step : {1, 3, 7, 8, 9, 135, 136, 137}) {
+            hashlib::sha3_256 ctx;
+            for (std::size_t i = 0; i < input.size(); i += step) {
+                ctx.update(input.substr(i, step));
+                CHECK_EQ(ctx.hexdigest(), hashlib::sha3_256{input.substr(0, i + step)}.hexdigest());
+            }
+        }
+        CHECK_LE(sizeof(hashlib::sha3_256), 208);
+    }
+
     SUBCASE("random access range") {
         std::pair<const char*, std::deque<unsigned char>> deques[] {
             {
@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha3.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha3_384") {
         CHECK_EQ(sha3_384.hexdigest(), "83bff28dde1b1bf5810071c6643c08e5b05bdb836effd70b403ea8ea0a634dc4997eb1053aa3593f590f9c63630dd90b");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha3_384.update(bytes.begin(), bytes.begin() + 5);
+        sha3_384.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha3_384.hexdigest(), "83bff28dde1b1bf5810071c6643c08e5b05bdb836effd70b403ea8ea0a634dc4997eb1053aa3593f590f9c63630dd90b");
+    }
+
     SUBCASE("multiple updates") {
         sha3_384.update("The quick brown fox "_s);
         sha3_384.update("jumps over "_s);
@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha3.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha3_512") {
         CHECK_EQ(sha3_512.hexdigest(), "840006653e9ac9e95117a15c915caab81662918e925de9e004f774ff82d7079a40d4d27b1b372657c61d46d470304c88c788b3a4527ad074d1dccbee5dbaa99a");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha3_512.update(bytes.begin(), bytes.begin() + 5);
+        sha3_512.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha3_512.hexdigest(), "840006653e9ac9e95117a15c915caab81662918e925de9e004f774ff82d7079a40d4d27b1b372657c61d46d470304c88c788b3a4527ad074d1dccbee5dbaa99a");
+    }
+
     SUBCASE("multiple updates") {
         sha3_512.update("The quick brown fox "_s);
         sha3_512.update("jumps over "_s);
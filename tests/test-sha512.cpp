@@ -1,4 +1,5 @@
 #include <deque>
+#include <vector>
 #include <hashlib/sha2.hpp>
 #include "common.h"
 
@@ -15,6 +16,14 @@ TEST_CASE("testing sha512") {
         CHECK_EQ(sha512.hexdigest(), "309ecc489c12d6eb4cc40f50c902f2b4d0ed77ee511a7c7a9bcd3ca86d4cd86f989dd35bc5ff499670da34255b45b0cfd830e81f605dcf7dc5542e93ae9cd76f");
     }
 
+    SUBCASE("contiguous iterators") {
+        std::string input = "hello world";
+        std::vector<char> bytes(input.begin(), input.end());
+        sha512.update(bytes.begin(), bytes.begin() + 5);
+        sha512.update(input.cbegin() + 5, input.cend());
+        CHECK_EQ(sha512.hexdigest(), "309ecc489c12d6eb4cc40f50c902f2b4d0ed77ee511a7c7a9bcd3ca86d4cd86f989dd35bc5ff499670da34255b45b0cfd830e81f605dcf7dc5542e93ae9cd76f");
+    }
+
     SUBCASE("multiple updates with clear") {
         sha512.update("test1"_s);
         sha512.clear();
@@ -0,0 +1,67 @@
+#include <hashlib/md5.hpp>
+#include <hashlib/sha1.hpp>
+#include <hashlib/sha2.hpp>
+#include <hashlib/sha3.hpp>
+#include <stdexcept>
+#include <vector>
+#include "common.h"
+
+namespace {
+    template<typename Algo>
+    auto check_state(const std::string& content) -> void {
+        for (std::size_t cut : {0, 1, 63, 64, 65, 71, 72, 127, 128, 136, 143, 144, 145, 1000}) {
+            CAPTURE(cut);
+            Algo first{content.substr(0, cut)};
+            auto image = first.export_state();
+
+            Algo second;
+            second.import_state({image.data(), image.size()});
+            second.update(content.substr(cut));
+            CHECK_EQ(second.hexdigest(), Algo{content}.hexdigest());
+            CHECK_EQ(second.export_state(), Algo{content}.export_state());
+        }
+    }
+}
+
+TEST_CASE("testing export_state") {
+    std::string content;
+    for (std::size_t i = 0; i < 3000; ++i) {
+        content.push_back(static_cast<char>(i * 131 + i / 7));
+    }
+
+    check_state<hashlib::md5>(content);
+    check_state<hashlib::sha1>(content);
+    check_state<hashlib::sha224>(content);
+    check_state<hashlib::sha256>(content);
+    check_state<hashlib::sha384>(content);
+    check_state<hashlib::sha512>(content);
+    check_state<hashlib::sha3_224>(content);
+    check_state<hashlib::sha3_256>(content);
+    check_state<hashlib::sha3_384>(content);
+    check_state<hashlib::sha3_512>(content);
+
+    SUBCASE("format") {
+        // the same bytes on every platform
+        auto image = hashlib::md5{std::string{"abc"}}.export_state();
+        std::vector<hashlib::byte> expected{
+            1, 16, 64,
+            3, 0, 0, 0, 0, 0, 0, 0,
+            0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+            0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+            'a', 'b', 'c'
+        };
+        CHECK_EQ(image, expected);
+    }
+
+    SUBCASE("invalid states") {
+        auto image = hashlib::sha256{content.substr(0, 100)}.export_state();
+        hashlib::sha224 other;
+        CHECK_THROWS_AS(other.import_state({image.data(), image.size()}), std::invalid_argument);
+        hashlib::sha256 ctx;
+        CHECK_THROWS_AS(ctx.import_state({image.data(), image.size() - 1}), std::invalid_argument);
+        CHECK_THROWS_AS(ctx.import_state({image.data(), 5}), std::invalid_argument);
+        image[0] = 2;
+        CHECK_THROWS_AS(ctx.import_state({image.data(), image.size()}), std::invalid_argument);
+        CHECK_EQ(ctx.hexdigest(), hashlib::sha256{}.hexdigest());
+    }
+}
@@ -0,0 +1,79 @@
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <hashlib/sha2.hpp>
+#include <hashlib/stream.hpp>
+#include "common.h"
+
+namespace {
+    // formatted output, single characters, short writes and writes larger than the internal buffer.
+    auto write_payload(std::ostream& os) -> void {
+        for (int i = 0; i < 20000; ++i) {
+            os << i << ' ' << std::setw(8) << std::hex << i * 7 << std::dec << '\n';
+            if (i % 5000 == 0) os << std::string(100000 + i, static_cast<char>('a' + i % 26));
+        }
+        os.put('!');
+    }
+
+    struct throwing_buf : std::streambuf {
+    protected:
+        auto xsputn(const char*, std::streamsize) -> std::streamsize override {
+            throw std::runtime_error("tee failed");
+        }
+    };
+}
+
+TEST_CASE("testing hashing_streambuf") {
+    std::ostringstream expected;
+    write_payload(expected);
+    auto payload = expected.str();
+
+    SUBCASE("swallow") {
+        hashlib::hashing_ostream<hashlib::sha256> os;
+        write_payload(os);
+        CHECK(os.good());
+        CHECK_EQ(os.digest(), hashlib::sha256{payload}.digest());
+    }
+
+    SUBCASE("tee") {
+        std::stringbuf sink;
+        hashlib::hashing_streambuf<hashlib::sha256> buf{&sink};
+        std::ostream os{&buf};
+        write_payload(os);
+        CHECK_EQ(buf.hexdigest(), hashlib::sha256{payload}.hexdigest());
+        CHECK_EQ(sink.str(), payload);
+    }
+
+    SUBCASE("tee ostream") {
+        std::ostringstream copy;
+        {
+            hashlib::hashing_ostream<hashlib::sha256> os{copy};
+            os << "abc";
+            CHECK_EQ(os.hexdigest(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+            os << "def";
+        }
+        // the rest of the buffer reaches the tee when the stream is destroyed
+        CHECK_EQ(copy.str(), "abcdef");
+    }
+
+    SUBCASE("throwing tee") {
+        throwing_buf sink;
+        {
+            hashlib::hashing_streambuf<hashlib::sha256> buf{&sink};
+            std::ostream os{&buf};
+            os << "abc";
+            // the destructor flushes to the tee and must not let its exception escape
+        }
+        hashlib::hashing_streambuf<hashlib::sha256> buf{&sink};
+        CHECK_EQ(buf.sputn("abc", 3), 3);
+        CHECK_THROWS_AS(buf.pubsync(), std::runtime_error);
+    }
+
+    SUBCASE("digest and continue") {
+        hashlib::hashing_ostream<hashlib::sha256> os;
+        os << payload.substr(0, 1000);
+        CHECK_EQ(os.digest(), hashlib::sha256{payload.substr(0, 1000)}.digest());
+        os << payload.substr(1000);
+        CHECK_EQ(os.digest(), hashlib::sha256{payload}.digest());
+    }
+}